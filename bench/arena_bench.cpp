@@ -0,0 +1,112 @@
+/*
+ * File:   arena_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 11:50 PM
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <vector>
+#include "../data/arena.hpp"
+#include "../data/serialized_size.hpp"
+#include "./harness.hpp"
+
+/* Decode-and-drop of many small maps, as a request path does it: the
+ * global heap, an arena released after every map, and an arena_snapshot
+ * replaced by every map. An object is one decoded message. The report is
+ * CSV on stdout (see harness.hpp); heap calls, counted through operator
+ * new, go to stderr per message. The argument, if any, is the time budget
+ * per row in seconds. */
+
+namespace
+{
+    size_t allocations = 0;
+
+    const size_t messages = 1000;
+
+    template <typename F>
+    void measure (bench::harness& harness, const char* name, const std::string& buffer, F&& decode)
+    {
+        harness.measure("message", name, "decode", messages, buffer.size() * messages, [&] (size_t)
+        {
+            data::span_source source (buffer);
+            decode(source);
+        });
+        /* Counted once the harness has warmed the target up. */
+        const size_t before = allocations;
+        for (size_t i = 0; i < messages; ++i)
+        {
+            data::span_source source (buffer);
+            decode(source);
+        }
+        std::cerr << name << ": " << static_cast<double>(allocations - before) / messages << " new/msg" << std::endl;
+    }
+};
+
+void* operator new (size_t n)
+{
+    ++allocations;
+    if (void* p = std::malloc(n))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete (void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete (void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+int main (int argc, char** argv)
+{
+    typedef std::map<std::string, std::vector<std::string>> heap_map;
+    typedef std::pmr::map<std::pmr::string, std::pmr::vector<std::pmr::string>> pmr_map;
+
+    heap_map message;
+    for (int i = 0; i < 64; ++i)
+    {
+        std::vector<std::string>& values = message["header-" + std::to_string(i * 7919)];
+        for (int j = 0; j < 3; ++j)
+        {
+            values.push_back("value " + std::to_string(j) + " of a field long enough to leave SSO");
+        }
+    }
+    const std::string buffer = data::encode(message);
+
+    std::cerr << "message: " << buffer.size() << " bytes" << std::endl;
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+
+    data::default_binder binder;
+    measure(harness, "heap", buffer, [&binder] (data::basic_source& source)
+    {
+        heap_map x;
+        binder(x, source);
+    });
+
+    data::arena resource;
+    measure(harness, "arena", buffer, [&resource] (data::basic_source& source)
+    {
+        {
+            pmr_map x = data::decode<pmr_map>(source, &resource);
+        }
+        resource.release();
+    });
+
+    data::arena_snapshot<pmr_map> snapshot;
+    measure(harness, "snapshot", buffer, [&snapshot] (data::basic_source& source)
+    {
+        snapshot.load(source);
+    });
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * File:   async_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 3:40 AM
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <iostream>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../data/async_sink.hpp"
+#include "../data/basic_binder.hpp"
+#include "./harness.hpp"
+
+/* Latency of the serializing thread while snapshots go to a file: one
+ * pass writes every record and makes the snapshot durable, either through
+ * fd_sink and a blocking fsync, or through async_file_sink and persist().
+ * The report is CSV on stdout (see harness.hpp); the arguments, if any,
+ * are the time budget per row in seconds and the file to write. */
+
+namespace
+{
+    typedef std::tuple<uint64_t, std::string, std::vector<int32_t>> record_t;
+
+    const size_t count = 4096;
+
+    std::string text (std::mt19937_64& random, size_t length)
+    {
+        std::string result (length, ' ');
+        for (char& c : result)
+        {
+            c = static_cast<char>('a' + random() % 26);
+        }
+        return result;
+    }
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    const std::string path = argc > 2 ? argv[2] : "./async_bench.img";
+    std::mt19937_64 random (count);
+
+    std::vector<record_t> records (count);
+    for (record_t& x : records)
+    {
+        x = std::make_tuple(static_cast<uint64_t>(random()), text(random, 32 + random() % 96), std::vector<int32_t>(128 + random() % 128));
+    }
+    std::string encoded;
+    data::default_binder binder;
+    {
+        data::string_sink sink (encoded);
+        for (const record_t& x : records)
+        {
+            binder(sink, x);
+        }
+    }
+
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Cannot open " << path << std::endl;
+            return 1;
+        }
+        data::fd_sink sink (fd);
+        harness.measure("snapshot", "fd_sink+fsync", "encode", count, encoded.size(), [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                ::lseek(fd, 0, SEEK_SET);
+            }
+            binder(static_cast<data::basic_sink&>(sink), records[i]);
+            if (i + 1 == count)
+            {
+                sink.flush();
+                ::fsync(fd);
+            }
+        });
+        ::close(fd);
+    }
+
+    for (size_t in_flight : {1, 2, 4})
+    {
+        std::future<size_t> durable;
+        size_t stalls = 0;
+        {
+            /* One file per snapshot pass would measure the file system;
+             * the sink rewrites the same range instead. */
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            std::unique_ptr<data::async_file_sink> sink (new data::async_file_sink(fd, 0, 256 * 1024, in_flight));
+            harness.measure("snapshot", "async/" + std::to_string(in_flight), "encode", count, encoded.size(), [&] (size_t i)
+            {
+                if (i == 0 && sink->size() > 0)
+                {
+                    sink->close();
+                    sink.reset(new data::async_file_sink(fd, 0, 256 * 1024, in_flight));
+                }
+                binder(static_cast<data::basic_sink&>(*sink), records[i]);
+                if (i + 1 == count)
+                {
+                    durable = sink->persist();
+                }
+            });
+            durable.get();
+            stalls = sink->stalls();
+            sink.reset();
+            ::close(fd);
+        }
+        std::cerr << "async/" << in_flight << ": " << stalls << " stalls in the last pass" << std::endl;
+    }
+    ::unlink(path.c_str());
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+ * File:   float_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 9:35 PM
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../data/packed_binder.hpp"
+#include "./harness.hpp"
+
+/* Bytes per value and throughput of xor_float_binder against the plain
+ * sequence path of default_binder, over a sink and a source. An object is
+ * a slice of length consecutive values of a series, so objects_per_s *
+ * length * the value size is the in-memory rate. The report is CSV on
+ * stdout (see harness.hpp); the argument, if any, is the time budget per
+ * row in seconds.
+ *
+ * Synthetic series: a constant, a counter, random bits. Realistic ones are
+ * shaped like telemetry: a gauge sampled with two decimals, a CPU load
+ * percentage that mostly repeats, a price series moving in ticks, and a
+ * float temperature sensor with noise in the last digit. */
+
+namespace
+{
+    const size_t count = 1 << 20;
+    const size_t length = 4096;
+
+    template <typename F>
+    bool same (const std::vector<std::vector<F>>& x, const std::vector<std::vector<F>>& y)
+    {
+        for (size_t i = 0; i < x.size(); ++i)
+        {
+            if (x[i].size() != y[i].size() || std::memcmp(x[i].data(), y[i].data(), x[i].size() * sizeof(F)) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <typename B, typename F>
+    void measure (bench::harness& harness, const char* name, const char* data_name, const std::vector<std::vector<F>>& objects)
+    {
+        B binder;
+        std::vector<std::string> encoded (objects.size());
+        size_t bytes = 0;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            {
+                data::string_sink sink (encoded[i]);
+                binder(static_cast<data::basic_sink&>(sink), objects[i]);
+            }
+            bytes += encoded[i].size();
+        }
+
+        std::string buffer;
+        harness.measure(data_name, name, "encode", objects.size(), bytes, [&] (size_t i)
+        {
+            buffer.clear();
+            data::string_sink sink (buffer);
+            binder(static_cast<data::basic_sink&>(sink), objects[i]);
+        });
+
+        std::vector<std::vector<F>> targets (objects.size());
+        harness.measure(data_name, name, "decode", objects.size(), bytes, [&] (size_t i)
+        {
+            data::span_source source (encoded[i]);
+            binder(targets[i], static_cast<data::basic_source&>(source));
+        });
+        if (!same(targets, objects))
+        {
+            std::cerr << name << " does not round-trip " << data_name << std::endl;
+            std::exit(1);
+        }
+    }
+
+    template <typename F>
+    void run (bench::harness& harness, const char* data_name, const std::vector<F>& x)
+    {
+        std::vector<std::vector<F>> objects;
+        for (size_t first = 0; first < x.size(); first += length)
+        {
+            objects.emplace_back(x.begin() + first, x.begin() + std::min(x.size(), first + length));
+        }
+        measure<data::default_binder>(harness, "plain", data_name, objects);
+        measure<data::packing_binder>(harness, "xor", data_name, objects);
+    }
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    std::mt19937_64 random (count);
+
+    run(harness, "constant", std::vector<double>(count, 42.5));
+
+    std::vector<double> counter (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        counter[i] = static_cast<double>(i);
+    }
+    run(harness, "counter", counter);
+
+    std::vector<double> noise (count);
+    for (double& x : noise)
+    {
+        uint64_t bits = random() >> 2;
+        std::memcpy(&x, &bits, sizeof(x));
+    }
+    run(harness, "random", noise);
+
+    std::vector<double> gauge (count);
+    double level = 500;
+    for (double& x : gauge)
+    {
+        level = std::max(0.0, level + static_cast<double>(static_cast<int>(random() % 201) - 100) / 100);
+        x = std::round(level * 100) / 100;
+    }
+    run(harness, "gauge", gauge);
+
+    std::vector<double> cpu (count);
+    double load = 12;
+    for (double& x : cpu)
+    {
+        if (random() % 8 == 0)
+        {
+            load = static_cast<double>(random() % 1000) / 10;
+        }
+        x = load;
+    }
+    run(harness, "cpu", cpu);
+
+    std::vector<double> price (count);
+    int64_t ticks = 1234500;
+    for (double& x : price)
+    {
+        ticks += static_cast<int64_t>(random() % 5) - 2;
+        x = static_cast<double>(ticks) * 0.0001;
+    }
+    run(harness, "price", price);
+
+    std::vector<float> sensor (count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        sensor[i] = static_cast<float>(21.5 + 3 * std::sin(static_cast<double>(i) / 8640) + static_cast<double>(random() % 10) / 100);
+    }
+    run(harness, "sensor", sensor);
+    return 0;
+}
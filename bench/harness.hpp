@@ -0,0 +1,105 @@
+/*
+ * File:   harness.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 12:10 AM
+ */
+
+#ifndef HARNESS_HPP
+#define	HARNESS_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* Minimal benchmark harness writing one CSV row per measurement:
+ *
+ *   case,binder,op,objects,bytes_per_object,objects_per_s,mb_per_s,
+ *   p50_ns,p90_ns,p99_ns,max_ns
+ *
+ * An operation is called on objects 0..count-1 in passes until the time
+ * budget is spent (and at least min_passes times). Latencies are per
+ * object, timed over batches sized to last about a microsecond so that
+ * the clock does not dominate small objects; MB/s counts encoded bytes. */
+
+namespace bench
+{
+    class harness
+    {
+    public:
+        typedef std::chrono::steady_clock clock_type;
+
+        static const size_t min_passes = 3;
+
+        explicit harness (std::ostream& out, double budget = 0.25) : m_out(out), m_budget(budget)
+        {
+            m_out << "case,binder,op,objects,bytes_per_object,objects_per_s,mb_per_s,p50_ns,p90_ns,p99_ns,max_ns" << std::endl;
+        }
+
+        /* op(i) processes object i; bytes is the encoded size of a pass. */
+        template <typename F>
+        void measure (const std::string& name, const std::string& binder, const std::string& op, size_t count, size_t bytes, F&& f)
+        {
+            clock_type::time_point start = clock_type::now();
+            for (size_t i = 0; i < count; ++i)
+            {
+                f(i);
+            }
+            const double warmup = __nanoseconds(start, clock_type::now()) / static_cast<double>(count);
+            const size_t batch = std::min(count, std::max<size_t>(1, static_cast<size_t>(std::ceil(__batch_ns / std::max(warmup, 1.0)))));
+
+            std::vector<double> samples;
+            double total = 0;
+            size_t passes = 0;
+            while (passes < min_passes || total < m_budget * 1e9)
+            {
+                for (size_t first = 0; first < count; first += batch)
+                {
+                    const size_t last = std::min(count, first + batch);
+                    clock_type::time_point begin = clock_type::now();
+                    for (size_t i = first; i < last; ++i)
+                    {
+                        f(i);
+                    }
+                    const double elapsed = __nanoseconds(begin, clock_type::now());
+                    total += elapsed;
+                    samples.push_back(elapsed / static_cast<double>(last - first));
+                }
+                ++passes;
+            }
+            std::sort(samples.begin(), samples.end());
+
+            const double seconds = total / 1e9;
+            m_out << name << ',' << binder << ',' << op << ',' << count << ','
+                    << std::fixed << std::setprecision(2)
+                    << static_cast<double>(bytes) / static_cast<double>(count) << ','
+                    << static_cast<double>(count * passes) / seconds << ','
+                    << static_cast<double>(bytes * passes) / seconds / 1e6 << ','
+                    << __percentile(samples, 0.5) << ',' << __percentile(samples, 0.9) << ','
+                    << __percentile(samples, 0.99) << ',' << samples.back() << std::endl;
+        }
+    private:
+        static constexpr double __batch_ns = 1000;
+
+        static double __nanoseconds (clock_type::time_point first, clock_type::time_point last)
+        {
+            return std::chrono::duration<double, std::nano>(last - first).count();
+        }
+
+        static double __percentile (const std::vector<double>& sorted, double rank)
+        {
+            return sorted[std::min(sorted.size() - 1, static_cast<size_t>(rank * static_cast<double>(sorted.size())))];
+        }
+
+        std::ostream& m_out;
+        double m_budget;
+    };
+};
+
+#endif	/* HARNESS_HPP */
+
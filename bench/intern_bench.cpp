@@ -0,0 +1,108 @@
+/*
+ * File:   intern_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 5:50 AM
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../data/basic_binder.hpp"
+#include "../data/interning_binder.hpp"
+#include "./harness.hpp"
+
+/* Log records whose strings repeat: a host out of 500 and a tag out of
+ * 20, written as one stream by default_binder and by interning_binder,
+ * and read back into std::string or, with the string table, into shared
+ * std::shared_ptr<const std::string>. The report is CSV on stdout (see
+ * harness.hpp); the argument, if any, is the time budget per row in
+ * seconds. */
+
+namespace
+{
+    typedef std::tuple<uint64_t, std::string, std::string, int32_t> record_t;
+    typedef std::tuple<uint64_t, std::shared_ptr<const std::string>, std::shared_ptr<const std::string>, int32_t> shared_record_t;
+
+    const size_t count = 100000;
+
+    template <typename B>
+    auto __reset (B& binder, int) -> decltype(binder.reset(), void())
+    {
+        binder.reset();
+    }
+
+    template <typename B>
+    void __reset (B&, long) {}
+
+    template <typename B, typename T>
+    void run (bench::harness& harness, const std::string& label, const std::vector<record_t>& records, std::vector<T>& targets)
+    {
+        B binder;
+        std::string encoded;
+        {
+            data::string_sink sink (encoded);
+            for (const record_t& x : records)
+            {
+                binder(sink, x);
+            }
+        }
+        std::cerr << label << ": " << encoded.size() << " bytes" << std::endl;
+        harness.measure("records", label, "encode", count, encoded.size(), [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                encoded.clear();
+                __reset(binder, 0);
+            }
+            data::string_sink sink (encoded);
+            binder(sink, records[i]);
+        });
+
+        B reader;
+        std::unique_ptr<data::span_source> source;
+        harness.measure("records", label, "decode", count, encoded.size(), [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                source.reset(new data::span_source(encoded));
+                __reset(reader, 0);
+            }
+            reader(targets[i], *source);
+        });
+    }
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    std::mt19937_64 random (count);
+
+    std::vector<std::string> hosts;
+    for (size_t i = 0; i < 500; ++i)
+    {
+        hosts.push_back("web-" + std::to_string(i) + ".eu-west-" + std::to_string(i % 3) + ".example.internal");
+    }
+    std::vector<std::string> tags;
+    for (size_t i = 0; i < 20; ++i)
+    {
+        tags.push_back("service/" + std::to_string(i * 7919 % 1000));
+    }
+    std::vector<record_t> records;
+    for (size_t i = 0; i < count; ++i)
+    {
+        records.emplace_back(1700000000000 + i, hosts[random() % hosts.size()], tags[random() % tags.size()], static_cast<int32_t>(random() % 600));
+    }
+
+    std::vector<record_t> decoded (count);
+    run<data::default_binder>(harness, "default", records, decoded);
+    run<data::interning_binder>(harness, "interning", records, decoded);
+    std::vector<shared_record_t> shared (count);
+    run<data::interning_binder>(harness, "interning/shared", records, shared);
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * File:   log_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 4:40 AM
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../data/basic_binder.hpp"
+#include "../data/map_log.hpp"
+#include "./harness.hpp"
+
+/* Cost of persisting one changed entry of a std::map<uint64_t, string>:
+ * rewriting the whole map through fd_sink, against appending the change
+ * to a map_log (compaction included). Both hand the bytes to the OS
+ * without syncing. The report is CSV on stdout (see harness.hpp); the
+ * arguments, if any, are the time budget per row in seconds and the file
+ * to write. */
+
+namespace
+{
+    typedef std::map<uint64_t, std::string> map_t;
+
+    const size_t changes = 256;
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    const std::string path = argc > 2 ? argv[2] : "./log_bench.img";
+    data::default_binder binder;
+
+    for (size_t entries : {1000, 10000, 100000})
+    {
+        std::mt19937_64 random (entries);
+        map_t map;
+        for (size_t i = 0; i < entries; ++i)
+        {
+            map[i] = std::string(16 + random() % 48, static_cast<char>('a' + i % 26));
+        }
+        const std::string name = "map/" + std::to_string(entries);
+
+        {
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0)
+            {
+                std::cerr << "Cannot open " << path << std::endl;
+                return 1;
+            }
+            size_t bytes = 0;
+            harness.measure(name, "rewrite", "change", changes, 0, [&] (size_t i)
+            {
+                map[random() % entries][0] = static_cast<char>('a' + i % 26);
+                ::lseek(fd, 0, SEEK_SET);
+                data::fd_sink sink (fd);
+                binder(static_cast<data::basic_sink&>(sink), map);
+                sink.flush();
+                bytes = sink.size();
+            });
+            std::cerr << name << " rewrite: " << bytes << " bytes per change" << std::endl;
+            ::close(fd);
+        }
+
+        std::remove(path.c_str());
+        {
+            data::map_log<map_t> log (path);
+            for (const map_t::value_type& x : map)
+            {
+                log.assign(x.first, x.second);
+            }
+            log.compact();
+            const uint64_t before = log.length();
+            size_t count = 0;
+            harness.measure(name, "map_log", "change", changes, 0, [&] (size_t i)
+            {
+                const uint64_t key = random() % entries;
+                std::string value = log->at(key);
+                value[0] = static_cast<char>('a' + i % 26);
+                log.assign(key, value);
+                log.flush();
+                ++count;
+            });
+            std::cerr << name << " map_log: " << log.length() << " bytes after " << count << " changes from " << before << std::endl;
+        }
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * File:   packed_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 8:45 PM
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../data/packed_binder.hpp"
+#include "./harness.hpp"
+
+/* Bytes per element and throughput of packed_integer_binder against the
+ * plain sequence path of default_binder, over a sink and a source. An
+ * object is a slice of length consecutive integers of a series, so
+ * objects_per_s * length * the integer size is the in-memory rate. The
+ * report is CSV on stdout (see harness.hpp); the argument, if any, is the
+ * time budget per row in seconds. */
+
+namespace
+{
+    const size_t count = 1 << 20;
+    const size_t length = 4096;
+
+    template <typename C>
+    std::vector<C> slice (const C& x)
+    {
+        std::vector<C> result;
+        for (auto iter = x.begin(); iter != x.end(); )
+        {
+            C part;
+            for (size_t i = 0; i < length && iter != x.end(); ++i, ++iter)
+            {
+                part.insert(part.end(), *iter);
+            }
+            result.push_back(part);
+        }
+        return result;
+    }
+
+    template <typename B, typename C>
+    void measure (bench::harness& harness, const char* name, const char* data_name, const std::vector<C>& objects)
+    {
+        B binder;
+        std::vector<std::string> encoded (objects.size());
+        size_t bytes = 0;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            {
+                data::string_sink sink (encoded[i]);
+                binder(static_cast<data::basic_sink&>(sink), objects[i]);
+            }
+            bytes += encoded[i].size();
+        }
+
+        std::string buffer;
+        harness.measure(data_name, name, "encode", objects.size(), bytes, [&] (size_t i)
+        {
+            buffer.clear();
+            data::string_sink sink (buffer);
+            binder(static_cast<data::basic_sink&>(sink), objects[i]);
+        });
+
+        std::vector<C> targets (objects.size());
+        harness.measure(data_name, name, "decode", objects.size(), bytes, [&] (size_t i)
+        {
+            data::span_source source (encoded[i]);
+            binder(targets[i], static_cast<data::basic_source&>(source));
+        });
+        if (targets != objects)
+        {
+            std::cerr << name << " does not round-trip " << data_name << std::endl;
+            std::exit(1);
+        }
+    }
+
+    template <typename C>
+    void run (bench::harness& harness, const char* data_name, const C& x)
+    {
+        const std::vector<C> objects = slice(x);
+        measure<data::default_binder>(harness, "plain", data_name, objects);
+        measure<data::packing_binder>(harness, "packed", data_name, objects);
+    }
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    std::mt19937_64 random (count);
+
+    std::vector<int64_t> timestamps (count);
+    int64_t now = 1790000000000000;
+    for (int64_t& x : timestamps)
+    {
+        x = now += 1000 + static_cast<int64_t>(random() % 64);
+    }
+    run(harness, "stamps", timestamps);
+
+    std::vector<int32_t> small (count);
+    for (int32_t& x : small)
+    {
+        x = static_cast<int32_t>(random() % 2000) - 1000;
+    }
+    run(harness, "small", small);
+
+    std::vector<uint32_t> noise (count);
+    for (uint32_t& x : noise)
+    {
+        x = static_cast<uint32_t>(random());
+    }
+    run(harness, "random", noise);
+
+    std::set<int> ids;
+    while (ids.size() < count / 4)
+    {
+        ids.insert(static_cast<int>(random() % (count * 4)));
+    }
+    run(harness, "set<int>", ids);
+    return 0;
+}
@@ -0,0 +1,258 @@
+/*
+ * File:   sox_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 12:20 AM
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "../sequence_saver.hpp"
+#include "../data/basic_binder.hpp"
+#include "../data/native_binder.hpp"
+#include "./harness.hpp"
+
+/* Encode and decode of scalars, strings, vectors, nested maps and tuples,
+ * one object at a time: composite_binder over a sink/source and over
+ * std::iostreams, the same in native byte order (native_binder, without
+ * the stream header), and the typed SequenceSaver/SequenceLoader records. The
+ * report is CSV on stdout (see harness.hpp); the first argument, if any,
+ * is the time budget per row in seconds. */
+
+namespace
+{
+    const size_t count = 1024;
+
+    size_t checksum = 0;
+
+    struct Counter
+    {
+        void begin (size_t, size_t length)
+        {
+            checksum += length;
+        }
+
+        void end (size_t) {}
+
+        void value (size_t, const char*, size_t size)
+        {
+            checksum += size;
+        }
+
+        void values (size_t, const char*, size_t count, size_t)
+        {
+            checksum += count;
+        }
+    };
+
+    template <typename B, typename T>
+    void composite (bench::harness& harness, const char* name, const std::string& label, const std::vector<T>& objects)
+    {
+        B binder;
+        std::vector<std::string> encoded (objects.size());
+        std::string joined;
+        size_t bytes = 0;
+        for (size_t i = 0; i < objects.size(); ++i)
+        {
+            {
+                data::string_sink sink (encoded[i]);
+                binder(sink, objects[i]);
+            }
+            bytes += encoded[i].size();
+            joined += encoded[i];
+        }
+
+        std::string buffer;
+        harness.measure(name, label + "/sink", "encode", objects.size(), bytes, [&] (size_t i)
+        {
+            buffer.clear();
+            data::string_sink sink (buffer);
+            binder(sink, objects[i]);
+        });
+
+        T target {};
+        harness.measure(name, label + "/sink", "decode", objects.size(), bytes, [&] (size_t i)
+        {
+            data::span_source source (encoded[i]);
+            binder(target, source);
+        });
+        if (!(target == objects.back()))
+        {
+            std::cerr << name << " does not round-trip" << std::endl;
+            std::exit(1);
+        }
+
+        std::ostringstream out;
+        harness.measure(name, label + "/stream", "encode", objects.size(), bytes, [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                out.seekp(0);
+            }
+            binder(static_cast<std::ostream&>(out), objects[i]);
+        });
+
+        std::istringstream in (joined);
+        harness.measure(name, label + "/stream", "decode", objects.size(), bytes, [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                in.clear();
+                in.seekg(0);
+            }
+            binder(target, static_cast<std::istream&>(in));
+        });
+    }
+
+    /* Records only: the schema a stream starts with is written once and
+     * left out of the byte count. */
+    template <typename T>
+    void legacy (bench::harness& harness, const char* name, const std::vector<T>& objects)
+    {
+        std::ostringstream probe;
+        native_saver probe_saver;
+        probe_saver(probe, objects[0]);
+        const size_t first = probe.str().size();
+        probe_saver(probe, objects[0]);
+        const size_t schema = 2 * first - probe.str().size();
+
+        std::ostringstream all;
+        native_saver all_saver;
+        for (const T& x : objects)
+        {
+            all_saver(all, x);
+        }
+        const size_t bytes = all.str().size() - schema;
+
+        native_saver saver;
+        std::ostringstream out;
+        harness.measure(name, "legacy", "encode", objects.size(), bytes, [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                out.seekp(0);
+            }
+            saver(out, objects[i]);
+        });
+
+        std::istringstream in (all.str());
+        std::unique_ptr<native_loader> loader;
+        Counter counter;
+        harness.measure(name, "legacy", "decode", objects.size(), bytes, [&] (size_t i)
+        {
+            if (i == 0)
+            {
+                loader.reset(new native_loader());
+                in.clear();
+                in.seekg(0);
+            }
+            (*loader)(in, loader->next(in), counter);
+        });
+    }
+
+    template <typename T>
+    void run (bench::harness& harness, const char* name, const std::vector<T>& objects)
+    {
+        composite<data::default_binder>(harness, name, "composite", objects);
+        composite<data::native_binder>(harness, name, "native", objects);
+        legacy(harness, name, objects);
+    }
+
+    struct tick
+    {
+        int64_t time;
+        double price;
+        int32_t size;
+        int32_t venue;
+
+        bool operator== (const tick& x) const
+        {
+            return time == x.time && price == x.price && size == x.size && venue == x.venue;
+        }
+    };
+
+    std::string text (std::mt19937_64& random, size_t length)
+    {
+        std::string result (length, ' ');
+        for (char& c : result)
+        {
+            c = static_cast<char>('a' + random() % 26);
+        }
+        return result;
+    }
+};
+
+DATA_FIELDS(tick, time, price, size, venue)
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    std::mt19937_64 random (count);
+
+    std::vector<uint64_t> scalars (count);
+    for (uint64_t& x : scalars)
+    {
+        x = random();
+    }
+    run(harness, "scalar", scalars);
+
+    std::vector<std::string> strings (count);
+    for (std::string& x : strings)
+    {
+        x = text(random, 8 + random() % 57);
+    }
+    run(harness, "string", strings);
+
+    std::vector<std::vector<int32_t>> vectors (count, std::vector<int32_t>(64));
+    for (std::vector<int32_t>& x : vectors)
+    {
+        for (int32_t& y : x)
+        {
+            y = static_cast<int32_t>(random());
+        }
+    }
+    run(harness, "vector", vectors);
+
+    std::vector<std::map<std::string, std::map<int32_t, std::string>>> maps (count);
+    for (std::map<std::string, std::map<int32_t, std::string>>& x : maps)
+    {
+        for (int i = 0; i < 8; ++i)
+        {
+            std::map<int32_t, std::string>& inner = x[text(random, 12)];
+            for (int j = 0; j < 4; ++j)
+            {
+                inner[static_cast<int32_t>(random() % 1000)] = text(random, 16);
+            }
+        }
+    }
+    run(harness, "map", maps);
+
+    std::vector<std::tuple<int64_t, double, std::string>> tuples (count);
+    for (std::tuple<int64_t, double, std::string>& x : tuples)
+    {
+        x = std::make_tuple(static_cast<int64_t>(random()), static_cast<double>(random() % 100000) / 100, text(random, 20));
+    }
+    run(harness, "tuple", tuples);
+
+    /* Packed structs: no legacy equivalent. */
+    std::vector<std::vector<tick>> ticks (count, std::vector<tick>(64));
+    for (std::vector<tick>& x : ticks)
+    {
+        for (tick& y : x)
+        {
+            y = tick {static_cast<int64_t>(random()), static_cast<double>(random() % 100000) / 100, static_cast<int32_t>(random()), static_cast<int32_t>(random() % 16)};
+        }
+    }
+    composite<data::default_binder>(harness, "struct", "composite", ticks);
+    composite<data::native_binder>(harness, "struct", "native", ticks);
+
+    return checksum == 0 ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+/*
+ * File:   varint_bench.cpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 4:40 PM
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../data/basic_binder.hpp"
+#include "./harness.hpp"
+
+/* Compares the previous byte-at-a-time length coding with data::varint and
+ * with length_binder over the sink/source layer, for lengths taking 1, 2, 5
+ * and 10 bytes and for a mix of widths that defeats branch prediction. An
+ * object is one length. The report is CSV on stdout (see harness.hpp); the
+ * argument, if any, is the time budget per row in seconds. */
+
+namespace legacy
+{
+    void encode (std::ostream& stream, size_t value)
+    {
+        size_t limits = 128;
+        size_t length = 0;
+        while (limits && value > limits)
+        {
+            ++length;
+            limits *= 128;
+        }
+        while (length > 0)
+        {
+            stream.put(static_cast<char>((value & 127) | 128));
+            value /= 128;
+            --length;
+        }
+        stream.put(static_cast<char>(value & 127));
+    }
+
+    size_t decode (std::istream& stream)
+    {
+        size_t value = 0;
+        size_t offset = 1;
+        char buffer;
+        while ((buffer = stream.get()) & 128)
+        {
+            value += (buffer & 127) * offset;
+            offset *= 128;
+        }
+        value += (buffer & 127) * offset;
+        return value;
+    }
+};
+
+namespace
+{
+    const size_t count = 1 << 20;
+
+    volatile size_t checksum = 0;
+
+    void run (bench::harness& harness, const std::string& name, const std::vector<size_t>& values)
+    {
+        {
+            std::stringstream encoded;
+            for (size_t x : values)
+            {
+                legacy::encode(encoded, x);
+            }
+            const size_t bytes = encoded.str().size();
+
+            std::stringstream out;
+            harness.measure(name, "legacy", "encode", count, bytes, [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    out.seekp(0);
+                }
+                legacy::encode(out, values[i]);
+            });
+            harness.measure(name, "legacy", "decode", count, bytes, [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    encoded.clear();
+                    encoded.seekg(0);
+                }
+                checksum += legacy::decode(encoded);
+            });
+        }
+
+        {
+            std::vector<char> buffer (count * data::varint::max_length);
+            char* out = buffer.data();
+            for (size_t x : values)
+            {
+                out += data::varint::encode(x, out);
+            }
+            const char* last = out;
+            const size_t bytes = static_cast<size_t>(last - buffer.data());
+
+            harness.measure(name, "varint", "encode", count, bytes, [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    out = buffer.data();
+                }
+                out += data::varint::encode(values[i], out);
+            });
+            const char* first = buffer.data();
+            harness.measure(name, "varint", "decode", count, bytes, [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    first = buffer.data();
+                }
+                uint64_t x;
+                first = data::varint::decode(first, last, x);
+                checksum += x;
+            });
+        }
+
+        {
+            data::length_binder binder;
+            std::string encoded;
+            {
+                data::string_sink sink (encoded);
+                for (size_t x : values)
+                {
+                    data::length_type length {x};
+                    binder(sink, length);
+                }
+            }
+
+            std::string buffer;
+            std::unique_ptr<data::string_sink> sink;
+            harness.measure(name, "length_binder", "encode", count, encoded.size(), [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    sink.reset();
+                    buffer.clear();
+                    sink.reset(new data::string_sink(buffer));
+                }
+                data::length_type length {values[i]};
+                binder(*sink, length);
+            });
+            std::unique_ptr<data::span_source> source;
+            harness.measure(name, "length_binder", "decode", count, encoded.size(), [&] (size_t i)
+            {
+                if (i == 0)
+                {
+                    source.reset(new data::span_source(encoded));
+                }
+                data::length_type length;
+                binder(length, *source);
+                checksum += length.value;
+            });
+        }
+    }
+};
+
+int main (int argc, char** argv)
+{
+    bench::harness harness (std::cout, argc > 1 ? std::atof(argv[1]) : 0.25);
+    run(harness, "len1", std::vector<size_t>(count, 100));
+    run(harness, "len2", std::vector<size_t>(count, 10000));
+    run(harness, "len5", std::vector<size_t>(count, (size_t(1) << 30) + 12345));
+    run(harness, "len10", std::vector<size_t>(count, ~size_t(0) - 12345));
+
+    std::mt19937_64 random (count);
+    std::vector<size_t> mixed (count);
+    for (size_t& x : mixed)
+    {
+        x = static_cast<size_t>(random() >> (random() % 64));
+    }
+    run(harness, "mix", mixed);
+    return 0;
+}
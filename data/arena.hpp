@@ -0,0 +1,367 @@
+/*
+ * File:   arena.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 11:20 PM
+ */
+
+#ifndef ARENA_HPP
+#define	ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+#include "./basic_binder.hpp"
+
+/* Arena-backed decoding. Containers decoded with an allocator hand it down
+ * to every element sequence_binder rebuilds (see allocated_value), so a
+ * whole decoded value lives in the arena it was built from and is freed
+ * with it in a few calls to the heap.
+ *
+ * Under C++17 the arena is a std::pmr::memory_resource and the std::pmr
+ * containers are the natural targets; under C++11 the same containers can
+ * be spelled with arena_allocator. */
+
+namespace data
+{
+    /* Monotonic bump allocator over a list of blocks growing geometrically
+     * from block_length. Deallocation does nothing; release() hands all
+     * memory back at once except the newest block, which is kept for the
+     * next round, so an arena reused per request stops touching the heap
+     * once it has grown to fit. Nothing allocated before a release() may
+     * be touched after it, destructors included. Not thread-safe. */
+    class arena
+#if __cplusplus >= 201703L
+        : public std::pmr::memory_resource
+#endif
+    {
+    public:
+        static const size_t default_block_length = 64 * 1024;
+
+        explicit arena (size_t block_length = default_block_length) : m_blocks(nullptr), m_cursor(nullptr), m_end(nullptr), m_block_length(std::max<size_t>(block_length, 256)), m_size(0) {}
+
+        arena (const arena&) = delete;
+        arena& operator= (const arena&) = delete;
+
+        ~arena()
+        {
+            release();
+            __free(m_blocks);
+        }
+
+#if __cplusplus < 201703L
+        void* allocate (size_t n, size_t alignment = alignof(std::max_align_t))
+        {
+            return __allocate(n, alignment);
+        }
+
+        void deallocate (void*, size_t, size_t = alignof(std::max_align_t)) {}
+#endif
+
+        void release ()
+        {
+            if (m_blocks != nullptr)
+            {
+                __free(m_blocks->next);
+                m_blocks->next = nullptr;
+                m_cursor = reinterpret_cast<char*>(m_blocks + 1);
+            }
+            m_size = 0;
+        }
+
+        /* Bytes handed out since the last release(). */
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        /* Bytes held from the heap. */
+        size_t capacity () const
+        {
+            size_t result = 0;
+            for (const block* iter = m_blocks; iter != nullptr; iter = iter->next)
+            {
+                result += iter->length;
+            }
+            return result;
+        }
+#if __cplusplus >= 201703L
+    protected:
+        void* do_allocate (size_t n, size_t alignment) override
+        {
+            return __allocate(n, alignment);
+        }
+
+        void do_deallocate (void*, size_t, size_t) override {}
+
+        bool do_is_equal (const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+#endif
+    private:
+        struct alignas(std::max_align_t) block
+        {
+            block* next;
+            size_t length;
+        };
+
+        void* __allocate (size_t n, size_t alignment)
+        {
+            char* first = __align(m_cursor, alignment);
+            if (m_cursor == nullptr || first > m_end || static_cast<size_t>(m_end - first) < n)
+            {
+                __grow(n, alignment);
+                first = __align(m_cursor, alignment);
+            }
+            m_cursor = first + n;
+            m_size += n;
+            return first;
+        }
+
+        /* Blocks at least double, so a value of n bytes takes O(log n) of
+         * them; the newest block is always the largest. */
+        void __grow (size_t n, size_t alignment)
+        {
+            size_t length = m_blocks != nullptr ? 2 * m_blocks->length : m_block_length;
+            while (length - sizeof(block) < n + alignment)
+            {
+                length *= 2;
+            }
+            void* memory = std::malloc(length);
+            if (memory == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            block* head = new (memory) block;
+            head->next = m_blocks;
+            head->length = length;
+            m_blocks = head;
+            m_cursor = reinterpret_cast<char*>(head + 1);
+            m_end = reinterpret_cast<char*>(head) + length;
+        }
+
+        static char* __align (char* cursor, size_t alignment)
+        {
+            uintptr_t address = reinterpret_cast<uintptr_t>(cursor);
+            return cursor + ((alignment - address % alignment) % alignment);
+        }
+
+        static void __free (block* iter)
+        {
+            while (iter != nullptr)
+            {
+                block* next = iter->next;
+                std::free(iter);
+                iter = next;
+            }
+        }
+
+        block* m_blocks;
+        char* m_cursor;
+        char* m_end;
+        size_t m_block_length;
+        size_t m_size;
+    };
+
+    /* Allocator drawing from an arena, for arena-backed containers without
+     * std::pmr. A copy of a container stays in the arena of the original;
+     * assignment keeps the arena of the target. */
+    template <typename T>
+    class arena_allocator
+    {
+    public:
+        typedef T value_type;
+
+        arena_allocator (arena* resource) : m_resource(resource) {}
+
+        template <typename U>
+        arena_allocator (const arena_allocator<U>& other) : m_resource(other.resource()) {}
+
+        T* allocate (size_t n)
+        {
+            return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate (T*, size_t) {}
+
+        arena* resource () const
+        {
+            return m_resource;
+        }
+    private:
+        arena* m_resource;
+    };
+
+    template <typename T, typename U>
+    bool operator== (const arena_allocator<T>& x, const arena_allocator<U>& y)
+    {
+        return x.resource() == y.resource();
+    }
+
+    template <typename T, typename U>
+    bool operator!= (const arena_allocator<T>& x, const arena_allocator<U>& y)
+    {
+        return x.resource() != y.resource();
+    }
+
+    typedef std::basic_string<char, std::char_traits<char>, arena_allocator<char>> arena_string;
+
+    template <typename A>
+    struct is_arena_allocator
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T>
+    struct is_arena_allocator<arena_allocator<T>>
+    {
+        typedef std::true_type type;
+        static const bool value = type::value;
+    };
+
+#if __cplusplus >= 201703L
+    template <typename T>
+    struct is_arena_allocator<std::pmr::polymorphic_allocator<T>>
+    {
+        typedef std::true_type type;
+        static const bool value = type::value;
+    };
+#endif
+
+    /* Whether a value built with the arena allocator A keeps all of its
+     * memory in the arena, so that dropping the arena frees it without
+     * running its destructor: trivially destructible types, and containers
+     * taking A of such values (std::pmr or arena_allocator ones, nested to
+     * any depth). */
+    template <typename T, typename A, typename = void>
+    struct is_arena_resident
+    {
+        typedef typename std::is_trivially_destructible<T>::type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T1, typename T2, typename A>
+    struct is_arena_resident<std::pair<T1, T2>, A, void>
+    {
+        typedef std::integral_constant<bool, is_arena_resident<typename std::remove_const<T1>::type, A>::value && is_arena_resident<T2, A>::value> type;
+        static const bool value = type::value;
+    };
+
+    template <typename T, typename A>
+    struct is_arena_resident<T, A, typename std::enable_if<is_arena_allocator<A>::value && std::uses_allocator<T, A>::value && !std::is_trivially_destructible<T>::value, decltype(void(std::declval<typename T::value_type*>()))>::type>
+    {
+        typedef typename is_arena_resident<typename T::value_type, A>::type type;
+        static const bool value = type::value;
+    };
+
+    /* Decodes a T whose allocator is made from resource, i.e. an arena or,
+     * under C++17, any std::pmr::memory_resource for the std::pmr
+     * containers; all nested strings and nodes come from the resource. */
+    template <typename T, typename B = default_binder, typename S, typename R>
+    T decode (S& stream, R* resource)
+    {
+        T result ((typename T::allocator_type(resource)));
+        B binder;
+        binder(result, stream);
+        return result;
+    }
+
+    /* A decoded value together with the arena it lives in. load() decodes
+     * the next value into a spare arena and then drops the previous one
+     * with the blocks it took: an arena-resident value is dropped without
+     * walking it to run destructors. The two arenas take turns, so a
+     * snapshot replaced over and over settles at two blocks. */
+    template <typename T, typename B = default_binder>
+    class arena_snapshot
+    {
+    public:
+        typedef T value_type;
+        typedef typename T::allocator_type allocator_type;
+
+        explicit arena_snapshot (size_t block_length = arena::default_block_length) : m_arena(new arena(block_length)), m_spare(new arena(block_length)), m_value(__make(*m_arena)) {}
+
+        arena_snapshot (const arena_snapshot&) = delete;
+        arena_snapshot& operator= (const arena_snapshot&) = delete;
+
+        ~arena_snapshot()
+        {
+            __drop(m_value);
+        }
+
+        template <typename S>
+        arena_snapshot& load (S& stream)
+        {
+            T* value = __make(*m_spare);
+            try
+            {
+                B binder;
+                binder(*value, stream);
+            }
+            catch (...)
+            {
+                __drop(value);
+                m_spare->release();
+                throw;
+            }
+            __drop(m_value);
+            m_arena.swap(m_spare);
+            m_spare->release();
+            m_value = value;
+            return *this;
+        }
+
+        const T& operator* () const
+        {
+            return *m_value;
+        }
+
+        const T* operator-> () const
+        {
+            return m_value;
+        }
+
+        const T& get () const
+        {
+            return *m_value;
+        }
+
+        /* Bytes the current value takes in its arena. */
+        size_t size () const
+        {
+            return m_arena->size();
+        }
+    private:
+        typedef is_arena_resident<T, allocator_type> resident_t;
+
+        static T* __make (arena& resource)
+        {
+            return new (resource.allocate(sizeof(T), alignof(T))) T(allocator_type(&resource));
+        }
+
+        static void __drop (T* value)
+        {
+            if (!resident_t::value)
+            {
+                value->~T();
+            }
+        }
+
+        std::unique_ptr<arena> m_arena;
+        std::unique_ptr<arena> m_spare;
+        T* m_value;
+    };
+};
+
+#endif	/* ARENA_HPP */
+
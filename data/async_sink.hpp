@@ -0,0 +1,406 @@
+/*
+ * File:   async_sink.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 3:05 AM
+ */
+
+#ifndef ASYNC_SINK_HPP
+#define	ASYNC_SINK_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+#include "./sink.hpp"
+
+namespace data
+{
+    /* File sink that serializes into one buffer while a background thread
+     * writes the ones filled before it, so the writing thread waits for the
+     * disk only when all in_flight buffers are still queued (see stalls()).
+     * Buffers queued back to back go out with one pwritev.
+     *
+     * Neither flush() nor a full buffer waits for the write; persist()
+     * returns a future that is ready once everything written so far is on
+     * stable storage. The first failure of the I/O thread is thrown as
+     * std::system_error from the next call that hands a buffer over (and
+     * from every persist() future still pending); nothing after it is
+     * written. close() waits for the queue to drain. */
+    class async_file_sink : public basic_sink
+    {
+    public:
+        static const size_t default_buffer_length = 1024 * 1024;
+        static const size_t default_in_flight = 2;
+
+        /* Creates or truncates path; the descriptor is owned. */
+        explicit async_file_sink (const std::string& path, size_t buffer_length = default_buffer_length, size_t in_flight = default_in_flight) : m_fd(-1), m_owned(true), m_base(0)
+        {
+#if defined(_WIN32)
+            m_fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            if (m_fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "open");
+            }
+            __start(buffer_length, in_flight);
+        }
+
+        /* Writes at offset of a descriptor that is not owned; its file
+         * position is left alone. */
+        async_file_sink (int fd, uint64_t offset, size_t buffer_length = default_buffer_length, size_t in_flight = default_in_flight) : m_fd(fd), m_owned(false), m_base(offset)
+        {
+            __start(buffer_length, in_flight);
+        }
+
+        ~async_file_sink()
+        {
+            try
+            {
+                close();
+            }
+            catch (const std::exception&) {}
+        }
+
+        /* Hands everything written so far to the I/O thread; the future
+         * yields size() once all of it is written and synced. */
+        std::future<size_t> persist ()
+        {
+            __hand_off(false);
+            __job job;
+            job.length = 0;
+            job.offset = size();
+            std::future<size_t> result = job.persisted.get_future();
+            {
+                std::lock_guard<std::mutex> lock (m_mutex);
+                m_jobs.push_back(std::move(job));
+            }
+            m_work.notify_one();
+            return result;
+        }
+
+        /* Writes out what is left, waits for it and closes an owned
+         * descriptor. Data is durable only after a persist(). */
+        void close ()
+        {
+            if (!m_thread.joinable())
+            {
+                return;
+            }
+            try
+            {
+                __hand_off(true);
+            }
+            catch (...)
+            {
+                __stop();
+                __close();
+                throw;
+            }
+            __stop();
+            int error = m_error;
+            if (__close() != 0 && error == 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "close");
+            }
+            if (error != 0)
+            {
+                throw std::system_error(error, std::generic_category(), m_operation);
+            }
+        }
+
+        /* Number of times the writing thread waited for a free buffer. */
+        size_t stalls () const
+        {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            return m_stalls;
+        }
+    protected:
+        void overflow (size_t n)
+        {
+            __hand_off(false);
+            if (n > m_current.size())
+            {
+                m_current.resize(n);
+                setp(&m_current[0], &m_current[0], &m_current[0] + m_current.size());
+            }
+        }
+
+        void sync ()
+        {
+            __hand_off(false);
+        }
+    private:
+        static const size_t __max_batch = 16;
+
+        /* A buffer to write, or a request to sync when length is 0. */
+        struct __job
+        {
+            std::vector<char_type> buffer;
+            size_t length;
+            uint64_t offset;
+            std::promise<size_t> persisted;
+        };
+
+        struct __chunk
+        {
+            char_type* data;
+            size_t length;
+        };
+
+        void __start (size_t buffer_length, size_t in_flight)
+        {
+            m_buffer_length = std::max<size_t>(buffer_length, 1);
+            m_free.resize(std::max<size_t>(in_flight, 1));
+            m_current.resize(m_buffer_length);
+            m_error = 0;
+            m_operation = "";
+            m_stalls = 0;
+            m_stop = false;
+            setp(&m_current[0], &m_current[0], &m_current[0] + m_current.size());
+            m_thread = std::thread(&async_file_sink::__run, this);
+        }
+
+        /* Queues the current buffer and, unless last, takes a free one. The
+         * window stays empty until it does, so a failure leaves nothing to
+         * write into. */
+        void __hand_off (bool last)
+        {
+            if (!m_thread.joinable())
+            {
+                throw std::system_error(EBADF, std::generic_category(), "write");
+            }
+            const size_t used = static_cast<size_t>(m_cursor - m_begin);
+            std::unique_lock<std::mutex> lock (m_mutex);
+            if (m_error != 0)
+            {
+                throw std::system_error(m_error, std::generic_category(), m_operation);
+            }
+            if (used > 0)
+            {
+                __job job;
+                job.buffer.swap(m_current);
+                job.length = used;
+                job.offset = m_base + m_offset;
+                m_jobs.push_back(std::move(job));
+                m_offset += used;
+                setp(nullptr, nullptr, nullptr);
+                m_work.notify_one();
+            }
+            if (last || !m_current.empty())
+            {
+                return;
+            }
+            if (m_free.empty())
+            {
+                ++m_stalls;
+                m_done.wait(lock, [this] () { return !m_free.empty() || m_error != 0; });
+                if (m_error != 0)
+                {
+                    throw std::system_error(m_error, std::generic_category(), m_operation);
+                }
+            }
+            m_current.swap(m_free.back());
+            m_free.pop_back();
+            lock.unlock();
+            if (m_current.size() < m_buffer_length)
+            {
+                m_current.resize(m_buffer_length);
+            }
+            setp(&m_current[0], &m_current[0], &m_current[0] + m_current.size());
+        }
+
+        void __stop ()
+        {
+            {
+                std::lock_guard<std::mutex> lock (m_mutex);
+                m_stop = true;
+            }
+            m_work.notify_one();
+            m_thread.join();
+        }
+
+        int __close ()
+        {
+            int fd = m_fd;
+            m_fd = -1;
+            if (!m_owned || fd < 0)
+            {
+                return 0;
+            }
+#if defined(_WIN32)
+            return ::_close(fd);
+#else
+            return ::close(fd);
+#endif
+        }
+
+        /* The I/O thread: takes queued buffers in order, a run of up to
+         * __max_batch at a time, and answers sync requests in between. */
+        void __run ()
+        {
+            std::unique_lock<std::mutex> lock (m_mutex);
+            while (true)
+            {
+                m_work.wait(lock, [this] () { return !m_jobs.empty() || m_stop; });
+                if (m_jobs.empty())
+                {
+                    return;
+                }
+                if (m_jobs.front().length == 0)
+                {
+                    __job job (std::move(m_jobs.front()));
+                    m_jobs.pop_front();
+                    int error = m_error;
+                    const char* operation = m_operation;
+                    lock.unlock();
+                    if (error == 0 && __sync(m_fd) != 0)
+                    {
+                        error = errno;
+                        operation = "fsync";
+                    }
+                    if (error == 0)
+                    {
+                        job.persisted.set_value(static_cast<size_t>(job.offset));
+                    }
+                    else
+                    {
+                        job.persisted.set_exception(std::make_exception_ptr(std::system_error(error, std::generic_category(), operation)));
+                    }
+                    lock.lock();
+                    __fail(error, operation);
+                    continue;
+                }
+                __chunk chunks [__max_batch];
+                size_t count = 0;
+                for (; count < m_jobs.size() && count < __max_batch && m_jobs[count].length > 0; ++count)
+                {
+                    chunks[count].data = &m_jobs[count].buffer[0];
+                    chunks[count].length = m_jobs[count].length;
+                }
+                const uint64_t offset = m_jobs.front().offset;
+                int error = m_error;
+                lock.unlock();
+                if (error == 0)
+                {
+                    error = __write(chunks, count, offset);
+                }
+                lock.lock();
+                __fail(error, "pwrite");
+                for (; count > 0; --count)
+                {
+                    m_free.push_back(std::move(m_jobs.front().buffer));
+                    m_jobs.pop_front();
+                }
+                m_done.notify_one();
+            }
+        }
+
+        void __fail (int error, const char* operation)
+        {
+            if (error != 0 && m_error == 0)
+            {
+                m_error = error;
+                m_operation = operation;
+                m_done.notify_one();
+            }
+        }
+
+        /* Writes the chunks back to back from offset on; returns errno. */
+        int __write (__chunk* chunks, size_t count, uint64_t offset)
+        {
+            while (count > 0)
+            {
+#if defined(_WIN32)
+                if (::_lseeki64(m_fd, static_cast<__int64>(offset), SEEK_SET) < 0)
+                {
+                    return errno;
+                }
+                auto written = ::_write(m_fd, chunks->data, static_cast<unsigned>(std::min<size_t>(chunks->length, 1u << 30)));
+#else
+                struct iovec vector [__max_batch];
+                for (size_t i = 0; i < count; ++i)
+                {
+                    vector[i].iov_base = chunks[i].data;
+                    vector[i].iov_len = chunks[i].length;
+                }
+                auto written = ::pwritev(m_fd, vector, static_cast<int>(count), static_cast<off_t>(offset));
+#endif
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return errno;
+                }
+                offset += static_cast<uint64_t>(written);
+                for (size_t left = static_cast<size_t>(written); left > 0 || (count > 0 && chunks->length == 0); )
+                {
+                    const size_t step = std::min(left, chunks->length);
+                    chunks->data += step;
+                    chunks->length -= step;
+                    left -= step;
+                    if (chunks->length == 0)
+                    {
+                        ++chunks;
+                        --count;
+                    }
+                }
+            }
+            return 0;
+        }
+
+        static int __sync (int fd)
+        {
+#if defined(_WIN32)
+            return ::_commit(fd);
+#elif defined(__linux__)
+            return ::fdatasync(fd);
+#else
+            return ::fsync(fd);
+#endif
+        }
+
+        int m_fd;
+        bool m_owned;
+        uint64_t m_base;
+        size_t m_buffer_length;
+        std::vector<char_type> m_current;
+        std::vector<std::vector<char_type>> m_free;
+        std::deque<__job> m_jobs;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_work;
+        std::condition_variable m_done;
+        int m_error;
+        const char* m_operation;
+        size_t m_stalls;
+        bool m_stop;
+        std::thread m_thread;
+    };
+};
+
+#endif	/* ASYNC_SINK_HPP */
+
@@ -12,7 +12,16 @@
 #include <tuple>
 #include <type_traits>
 #include <initializer_list>
+#include <memory>
+#include <climits>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
 #include "./serialization.hpp"
+#include "./sink.hpp"
+#include "./struct_binder.hpp"
+#include "./varint.hpp"
 
 namespace data
 {
@@ -64,6 +73,109 @@ namespace data
         static const bool value = type::value;
     };
 
+    template <typename T>
+    struct is_contiguous_sequence
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename _Tch, typename _Ttr, typename _Alloc>
+    struct is_contiguous_sequence<std::basic_string<_Tch, _Ttr, _Alloc>>
+    {
+        typedef std::true_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T, typename _Alloc>
+    struct is_contiguous_sequence<std::vector<T, _Alloc>>
+    {
+        typedef std::true_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename _Alloc>
+    struct is_contiguous_sequence<std::vector<bool, _Alloc>>
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T, typename _Tch, bool = is_contiguous_sequence<typename std::decay<T>::type>::value>
+    struct is_bulk_sequence
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T, typename _Tch>
+    struct is_bulk_sequence<T, _Tch, true>
+    {
+        typedef typename std::decay<T>::type::value_type underlying_t;
+
+        typedef std::integral_constant<bool, sizeof(_Tch) == 1 && std::is_scalar<underlying_t>::value> type;
+        static const bool value = type::value;
+    };
+
+    /* Element type a sequence can be decoded into before it is moved into
+     * the container; drops the constness of associative keys. */
+    template <typename T>
+    struct mutable_value
+    {
+        typedef T type;
+    };
+
+    template <typename T1, typename T2>
+    struct mutable_value<std::pair<T1, T2>>
+    {
+        typedef std::pair<typename std::remove_const<T1>::type, T2> type;
+    };
+
+    /* Makes the element a sequence decodes into with the allocator of the
+     * container it goes to, so nested strings and containers draw from the
+     * same resource (e.g. a std::pmr one) instead of the default heap.
+     * Types that take no allocator are value-initialized. */
+    template <typename T>
+    struct allocated_value
+    {
+        template <typename A>
+        static T make (const A& allocator)
+        {
+            typedef std::integral_constant<int, !std::uses_allocator<T, A>::value ? 0 :
+                    std::is_constructible<T, std::allocator_arg_t, const A&>::value ? 2 :
+                    std::is_constructible<T, const A&>::value ? 1 : 0> tag_t;
+            return __make(allocator, tag_t());
+        }
+    private:
+        template <typename A>
+        static T __make (const A& allocator, std::integral_constant<int, 2>)
+        {
+            return T(std::allocator_arg, allocator);
+        }
+
+        template <typename A>
+        static T __make (const A& allocator, std::integral_constant<int, 1>)
+        {
+            return T(allocator);
+        }
+
+        template <typename A>
+        static T __make (const A&, std::integral_constant<int, 0>)
+        {
+            return T {};
+        }
+    };
+
+    template <typename T1, typename T2>
+    struct allocated_value<std::pair<T1, T2>>
+    {
+        template <typename A>
+        static std::pair<T1, T2> make (const A& allocator)
+        {
+            return std::pair<T1, T2> (allocated_value<T1>::make(allocator), allocated_value<T2>::make(allocator));
+        }
+    };
+
     template <typename... Types>
     struct construct_tuple
     {
@@ -74,17 +186,58 @@ namespace data
         }
     };
 
-    template <typename _St = size_t>
+    /* Container serialized together with an offset table, one entry per
+     * Block elements, so that a reader can seek to any element; see
+     * indexed_binder and indexed_view. Otherwise it is the container C. */
+    template <typename C, size_t Block = 64>
+    class indexed : public C
+    {
+        static_assert(Block > 0, "Block length must be positive");
+    public:
+        typedef C container_type;
+        static const size_t block_length = Block;
+
+        using C::C;
+
+        indexed() : C() {}
+        indexed (const C& x) : C(x) {}
+        indexed (C&& x) : C(std::move(x)) {}
+    };
+
+    template <typename T>
+    struct is_indexed
+    {
+        template <typename C, size_t Block>
+        static std::true_type __test (const indexed<C, Block>*);
+
+        static std::false_type __test (...);
+
+        typedef decltype(__test(std::declval<typename std::decay<T>::type*>())) type;
+        static const bool value = type::value;
+    };
+
+    template <typename _St = size_t, typename _Order = big_endian_wire>
     struct sequence_binder
     {
         typedef _St size_type;
+        typedef _Order order_type;
 
-        template <typename T, typename _Tch, typename _Ttr, typename Cb>
-        typename std::enable_if<is_forward_sequence<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type
-        operator() (std::basic_ostream<_Tch, _Ttr>& stream, T&& x, Cb&& callback) const
+        order_type& order ()
+        {
+            return m_order;
+        }
+
+        const order_type& order () const
+        {
+            return m_order;
+        }
+
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_forward_sequence<T>::value && !is_bulk_sequence<T, typename S::char_type>::value, S&>::type
+        operator() (S& stream, T&& x, Cb&& callback) const
         {
             size_type length {};
-            for (auto iter = std::begin(std::forward<T>(x)); iter != std::end(std::forward<T>(x)); ++iter, ++length);
+            __set_length(length, __count(x, 0));
             callback(stream, length);
             for (auto iter = std::begin(std::forward<T>(x)); iter != std::end(std::forward<T>(x)); ++iter)
             {
@@ -93,37 +246,345 @@ namespace data
             return stream;
         }
 
+        /* Strings and vectors of scalars are written as a single block in
+         * the same byte order trivial_binder would produce element-wise. */
+        template <typename T, typename _Tch, typename _Ttr, typename Cb>
+        typename std::enable_if<is_bulk_sequence<T, _Tch>::value, std::basic_ostream<_Tch, _Ttr>&>::type
+        operator() (std::basic_ostream<_Tch, _Ttr>& stream, T&& x, Cb&& callback) const
+        {
+            typedef typename is_bulk_sequence<T, _Tch>::underlying_t underlying_t;
+            typedef SerializableSequence<underlying_t, _Tch> serializer_t;
+
+            size_type length {};
+            __set_length(length, x.size());
+            callback(stream, length);
+            if (x.empty())
+            {
+                return stream;
+            }
+            const underlying_t* first = &*std::begin(x);
+            if (serializer_t::length == 1 || !m_order.reverse_on_write())
+            {
+                return stream.write(reinterpret_cast<const _Tch*>(first), x.size() * serializer_t::length);
+            }
+            underlying_t chunk [__chunk_length / sizeof(underlying_t)];
+            for (size_t left = x.size(), step; left > 0; left -= step, first += step)
+            {
+                step = std::min(left, sizeof(chunk) / sizeof(underlying_t));
+                std::copy(first, first + step, chunk);
+                serializer_t::reverse(chunk, step);
+                stream.write(reinterpret_cast<const _Tch*>(chunk), step * serializer_t::length);
+            }
+            return stream;
+        }
+
+        /* Byte order is converted in place inside the sink window. */
+        template <typename T, typename Cb>
+        typename std::enable_if<is_bulk_sequence<T, basic_sink::char_type>::value, basic_sink&>::type
+        operator() (basic_sink& sink, T&& x, Cb&& callback) const
+        {
+            typedef typename is_bulk_sequence<T, basic_sink::char_type>::underlying_t underlying_t;
+            typedef SerializableSequence<underlying_t, basic_sink::char_type> serializer_t;
+
+            size_type length {};
+            __set_length(length, x.size());
+            callback(sink, length);
+            if (x.empty())
+            {
+                return sink;
+            }
+            const underlying_t* first = &*std::begin(x);
+            if (serializer_t::length == 1 || !m_order.reverse_on_write())
+            {
+                return sink.write(reinterpret_cast<const basic_sink::char_type*>(first), x.size() * serializer_t::length);
+            }
+            for (size_t left = x.size(), step; left > 0; left -= step, first += step)
+            {
+                step = std::min(left, __chunk_length / sizeof(underlying_t));
+                basic_sink::char_type* window = sink.reserve(step * serializer_t::length);
+                std::memcpy(window, first, step * serializer_t::length);
+                serializer_t::reverse(reinterpret_cast<underlying_t*>(window), step);
+                sink.commit(step * serializer_t::length);
+            }
+            return sink;
+        }
+
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_forward_sequence<T>::value && !is_bulk_sequence<T, typename S::char_type>::value, T&>::type
+        operator() (T& x, S& stream, Cb&& callback) const
+        {
+            size_type length {};
+            callback(length, stream);
+            x.clear();
+            __fill(x, __get_length(length), stream, callback, 0);
+            return x;
+        }
+
+        /* The target is grown in geometrically increasing chunks, so a
+         * corrupted length prefix fails on the stream instead of on one huge
+         * allocation. */
         template <typename T, typename _Tch, typename _Ttr, typename Cb>
-        typename std::enable_if<is_forward_sequence<T>::value, T&>::type
+        typename std::enable_if<is_bulk_sequence<T, _Tch>::value, T&>::type
         operator() (T& x, std::basic_istream<_Tch, _Ttr>& stream, Cb&& callback) const
         {
-            typedef typename std::decay<decltype(*std::begin(x))>::type underlying_t;
+            typedef typename is_bulk_sequence<T, _Tch>::underlying_t underlying_t;
+            typedef SerializableSequence<underlying_t, _Tch> serializer_t;
+
             typedef typename std::decay<T>::type type_t;
-            
+
             size_type length {};
             callback(length, stream);
-            std::vector<underlying_t> init_list;
-            underlying_t buffer;
-            while (length > 0)
+            type_t& target = const_cast<type_t&>(x);
+            target.clear();
+            for (size_t left = __get_length(length), done = 0, step; left > 0 && stream; left -= step, done += step)
             {
-                callback(buffer, stream);
-                init_list.push_back(buffer);
-                --length;
+                step = std::min(left, std::max(__chunk_length / sizeof(underlying_t), done));
+                target.resize(done + step);
+                underlying_t* first = &target[0] + done;
+                if (!stream.read(reinterpret_cast<_Tch*>(first), step * serializer_t::length))
+                {
+                    target.resize(done + static_cast<size_t>(stream.gcount()) / serializer_t::length);
+                    break;
+                }
+                if (serializer_t::length > 1 && m_order.reverse_on_read())
+                {
+                    serializer_t::reverse(first, step);
+                }
+            }
+            return x;
+        }
+
+        template <typename T, typename Cb>
+        typename std::enable_if<is_bulk_sequence<T, basic_source::char_type>::value, T&>::type
+        operator() (T& x, basic_source& source, Cb&& callback) const
+        {
+            typedef typename is_bulk_sequence<T, basic_source::char_type>::underlying_t underlying_t;
+            typedef SerializableSequence<underlying_t, basic_source::char_type> serializer_t;
+
+            typedef typename std::decay<T>::type type_t;
+
+            size_type length {};
+            callback(length, source);
+            type_t& target = const_cast<type_t&>(x);
+            target.clear();
+            for (size_t left = __get_length(length), done = 0, step; left > 0; left -= step, done += step)
+            {
+                step = std::min(left, std::max(__chunk_length / sizeof(underlying_t), done));
+                if (source.available() / sizeof(underlying_t) >= left)
+                {
+                    step = left;
+                }
+                target.resize(done + step);
+                underlying_t* first = &target[0] + done;
+                source.read(reinterpret_cast<basic_source::char_type*>(first), step * serializer_t::length);
+                if (serializer_t::length > 1 && m_order.reverse_on_read())
+                {
+                    serializer_t::reverse(first, step);
+                }
             }
-            type_t* ptr = reinterpret_cast<type_t*>((void*)&x);
-            __free_object(ptr);
-            new(ptr) type_t(std::begin(init_list), std::end(init_list));
             return x;
         }
     private:
-        template <typename T>
-        static typename std::enable_if<std::is_trivially_destructible<T>::value>::type __free_object (T* ptr)
-        {}
-        
-        template <typename T>
-        static typename std::enable_if<!std::is_trivially_destructible<T>::value>::type __free_object (T* ptr)
+        static const size_t __chunk_length = 4096;
+
+        static void __set_length (length_type& length, size_t value)
+        {
+            length.value = value;
+        }
+
+        template <typename L>
+        static void __set_length (L& length, size_t value)
+        {
+            length = static_cast<L>(value);
+        }
+
+        /* Capacity to reserve for a decoded element count: the count is
+         * untrusted, so it is capped by the bytes the source holds (an
+         * element takes one at least) or by one chunk. */
+        template <typename S>
+        static size_t __capacity (size_t length, const S& stream)
+        {
+            const size_t chunk = __chunk_length;
+            return std::min(length, __available(stream, chunk, typename std::is_base_of<basic_source, S>::type()));
+        }
+
+        static size_t __available (const basic_source& source, size_t chunk, std::true_type)
+        {
+            return std::max(chunk, source.available());
+        }
+
+        template <typename S>
+        static size_t __available (const S&, size_t chunk, std::false_type)
+        {
+            return chunk;
+        }
+
+        template <typename _Tch, typename _Ttr>
+        static bool __good (const std::basic_istream<_Tch, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+
+        static size_t __get_length (const length_type& length)
+        {
+            return length.value;
+        }
+
+        template <typename L>
+        static size_t __get_length (const L& length)
+        {
+            return static_cast<size_t>(length);
+        }
+
+        template <typename C>
+        static auto __count (const C& x, int) -> decltype(static_cast<size_t>(x.size()))
+        {
+            return static_cast<size_t>(x.size());
+        }
+
+        template <typename C>
+        static size_t __count (const C& x, long)
+        {
+            size_t length = 0;
+            for (auto iter = std::begin(x); iter != std::end(x); ++iter, ++length);
+            return length;
+        }
+
+        template <typename C>
+        static auto __reserve (C& target, size_t length, int) -> decltype(target.reserve(length), void())
+        {
+            target.reserve(length);
+        }
+
+        template <typename C>
+        static void __reserve (C&, size_t, long) {}
+
+        template <typename C>
+        static auto __allocator (const C& target, int) -> decltype(target.get_allocator())
         {
-            ptr->~T();
+            return target.get_allocator();
+        }
+
+        template <typename C>
+        static std::allocator<char> __allocator (const C&, long)
+        {
+            return std::allocator<char>();
+        }
+
+        template <typename C, typename V>
+        static auto __emplace (C& target, V&& x, int) -> decltype(target.emplace_back(std::forward<V>(x)), void())
+        {
+            target.emplace_back(std::forward<V>(x));
+        }
+
+        template <typename C, typename V>
+        static auto __emplace (C& target, V&& x, long) -> decltype(target.emplace_hint(target.end(), std::forward<V>(x)), void())
+        {
+            target.emplace_hint(target.end(), std::forward<V>(x));
+        }
+
+        template <typename C>
+        struct __element
+        {
+            typedef typename mutable_value<typename std::decay<decltype(*std::begin(std::declval<C&>()))>::type>::type type;
+        };
+
+        template <typename C, typename S, typename Cb>
+        static auto __fill (C& target, size_t length, S& stream, Cb& callback, int) -> decltype(__emplace(target, std::declval<typename __element<C>::type>(), 0), void())
+        {
+            typedef typename __element<C>::type element_t;
+
+            __reserve(target, __capacity(length, stream), 0);
+            for (; length > 0 && __good(stream); --length)
+            {
+                element_t buffer (allocated_value<element_t>::make(__allocator(target, 0)));
+                callback(buffer, stream);
+                __emplace(target, std::move(buffer), 0);
+            }
+        }
+
+        /* Containers that cannot append in place, such as std::forward_list,
+         * are built from a vector of their elements. */
+        template <typename C, typename S, typename Cb>
+        static void __fill (C& target, size_t length, S& stream, Cb& callback, long)
+        {
+            typedef typename __element<C>::type element_t;
+
+            std::vector<element_t> elements;
+            __reserve(elements, __capacity(length, stream), 0);
+            for (; length > 0 && __good(stream); --length)
+            {
+                elements.push_back(allocated_value<element_t>::make(__allocator(target, 0)));
+                callback(elements.back(), stream);
+            }
+            target = C(std::make_move_iterator(elements.begin()), std::make_move_iterator(elements.end()));
+        }
+
+        order_type m_order;
+    };
+
+    /* Writes an indexed<C> as its block length, the number of table entries,
+     * a table of 64-bit offsets of every Block-th element counted from the
+     * first one, and then the sequence exactly as sequence_binder writes it.
+     * Elements are encoded into a scratch buffer first to learn the offsets. */
+    struct indexed_binder
+    {
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_indexed<T>::value && sizeof(typename S::char_type) == 1, S&>::type
+        operator() (S& stream, T&& x, Cb&& callback) const
+        {
+            typedef typename std::decay<T>::type type_t;
+
+            std::string elements;
+            std::vector<uint64_t> offsets;
+            length_type length {};
+            {
+                string_sink sink (elements);
+                for (auto iter = std::begin(x); iter != std::end(x); ++iter, ++length.value)
+                {
+                    if (length.value % type_t::block_length == 0)
+                    {
+                        offsets.push_back(sink.size());
+                    }
+                    callback(sink, *iter);
+                }
+            }
+            length_type block {type_t::block_length};
+            length_type entries {offsets.size()};
+            callback(stream, block);
+            callback(stream, entries);
+            for (uint64_t offset : offsets)
+            {
+                callback(stream, offset);
+            }
+            callback(stream, length);
+            stream.write(elements.data(), elements.size());
+            return stream;
+        }
+
+        /* The table is skipped; elements are decoded by whichever binder
+         * handles the underlying container. */
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_indexed<T>::value, T&>::type
+        operator() (T& x, S& stream, Cb&& callback) const
+        {
+            typedef typename std::decay<T>::type type_t;
+
+            length_type block {};
+            length_type entries {};
+            callback(block, stream);
+            callback(entries, stream);
+            for (uint64_t offset; entries.value > 0; --entries.value)
+            {
+                callback(offset, stream);
+            }
+            callback(static_cast<typename type_t::container_type&>(const_cast<type_t&>(x)), stream);
+            return x;
         }
     };
 
@@ -184,17 +645,45 @@ namespace data
         }
     };
     
-    struct trivial_binder
+    template <typename _Order = big_endian_wire>
+    struct basic_trivial_binder
     {
+        typedef _Order order_type;
+
+        order_type& order ()
+        {
+            return m_order;
+        }
+
+        const order_type& order () const
+        {
+            return m_order;
+        }
+
         template <typename T, typename _Tch, typename _Ttr>
         typename std::enable_if<std::is_scalar<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type
         operator() (std::basic_ostream<_Tch, _Ttr>& stream, const T& x) const
         {
             SerializableSequence<T, _Tch> serializer;
             serializer.value = x;
-            serializer.serialize();
+            if (m_order.reverse_on_write())
+            {
+                serializer.reverse();
+            }
             return stream.write(serializer.sequence, serializer.length); 
         }
+
+        template <typename T>
+        typename std::enable_if<std::is_scalar<T>::value, basic_sink&>::type
+        operator() (basic_sink& sink, const T& x) const
+        {
+            SerializableSequence<T, basic_sink::char_type> serializer (x);
+            if (m_order.reverse_on_write())
+            {
+                serializer.reverse();
+            }
+            return sink.write(serializer.sequence, serializer.length);
+        }
         
         template <typename T, typename _Tch, typename _Ttr>
         typename std::enable_if<std::is_scalar<T>::value, T&>::type
@@ -202,11 +691,33 @@ namespace data
         {
             SerializableSequence<T, _Tch> serializer;
             stream.read(serializer.sequence, serializer.length);
-            serializer.serialize();
+            if (m_order.reverse_on_read())
+            {
+                serializer.reverse();
+            }
             x = serializer.value;
             return x;
         }
+
+        template <typename T>
+        typename std::enable_if<std::is_scalar<T>::value, T&>::type
+        operator() (T& x, basic_source& source) const
+        {
+            SerializableSequence<T, basic_source::char_type> serializer;
+            std::memcpy(serializer.sequence, source.require(serializer.length), serializer.length);
+            source.consume(serializer.length);
+            if (m_order.reverse_on_read())
+            {
+                serializer.reverse();
+            }
+            x = serializer.value;
+            return x;
+        }
+    private:
+        order_type m_order;
     };
+
+    typedef basic_trivial_binder<> trivial_binder;
     
     template <size_t Base, size_t Power>
     struct static_power
@@ -224,57 +735,234 @@ namespace data
     {
         template <typename _Tch, typename _Ttr>
         std::basic_ostream<_Tch, _Ttr>& operator() (std::basic_ostream<_Tch, _Ttr>& stream, length_type x) const
+        {
+            _Tch buffer [__max_length<_Tch>::value];
+            return stream.write(buffer, __encode(x.value, buffer));
+        }
+
+        basic_sink& operator() (basic_sink& sink, length_type x) const
+        {
+            sink.commit(varint::encode(x.value, sink.reserve(encoded_length(x.value))));
+            return sink;
+        }
+        
+        /* Truncated or overlong input sets failbit and leaves x untouched. */
+        template <typename _Tch, typename _Ttr>
+        length_type& operator() (length_type& x, std::basic_istream<_Tch, _Ttr>& stream) const
         {
             typedef decltype(std::declval<length_type>().value) underlying_t;
+            typedef typename std::make_unsigned<_Tch>::type unsigned_t;
             
             const size_t window_length = CHAR_BIT * sizeof(_Tch) - 1;
+            const size_t digits = CHAR_BIT * sizeof(underlying_t);
             const underlying_t mask = (static_power<2, window_length>::value - 1);
             
-            SerializableSequence<underlying_t, _Tch> serializer;
-            serializer.value = x.value;
-            underlying_t limits = static_power<2, window_length>::value;
-            size_t length = 0;
-            _Tch buffer;
-            
-            while (limits && serializer.value > limits)
+            underlying_t value = 0;
+            for (size_t shift = 0; ; shift += window_length)
             {
-                ++length;
-                limits *= static_power<2, window_length>::value;
+                typename _Ttr::int_type c = stream.get();
+                if (_Ttr::eq_int_type(c, _Ttr::eof()))
+                {
+                    return x;
+                }
+                underlying_t chunk = static_cast<unsigned_t>(_Ttr::to_char_type(c));
+                if (shift >= digits || (shift > 0 && ((chunk & mask) >> (digits - shift)) != 0))
+                {
+                    stream.setstate(std::ios_base::failbit);
+                    return x;
+                }
+                value |= (chunk & mask) << shift;
+                if (!(chunk & (mask + 1)))
+                {
+                    x.value = value;
+                    return x;
+                }
             }
+        }
+
+        length_type& operator() (length_type& x, basic_source& source) const
+        {
+            size_t window = source.fetch(varint::max_length);
+            const char* first = source.require(1);
+            const char* last = decode(first, first + window, x.value);
+            source.consume(static_cast<size_t>(last - first));
+            return x;
+        }
 
-            while (length > 0)
+        /* Number of bytes the encoding of x takes. */
+        static constexpr size_t encoded_length (size_t x)
+        {
+            return varint::encoded_length(x);
+        }
+
+        /* Decodes a length stored in [first, last) and returns the position
+         * past it; a truncated encoding throws std::out_of_range, an overlong
+         * one std::overflow_error. */
+        static const char* decode (const char* first, const char* last, size_t& x)
+        {
+            uint64_t value;
+            first = varint::decode(first, last, value);
+            if (static_cast<uint64_t>(static_cast<size_t>(value)) != value)
             {
-                buffer = (serializer.value & mask) | (mask + 1);
-                stream.put(buffer);
-                serializer.value /= static_power<2, window_length>::value;
-                --length;
+                throw std::overflow_error("Length exceeds size_t.");
             }
-            buffer = (serializer.value & mask);
-            stream.put(buffer);
-            return stream;
+            x = static_cast<size_t>(value);
+            return first;
         }
-        
-        template <typename _Tch, typename _Ttr>
-        length_type& operator() (length_type& x, std::basic_istream<_Tch, _Ttr>& stream) const
+    private:
+        template <typename _Tch>
+        struct __max_length
+        {
+            static const size_t window_length = CHAR_BIT * sizeof(_Tch) - 1;
+            static const size_t value = (CHAR_BIT * sizeof(size_t) + window_length - 1) / window_length;
+        };
+
+        static size_t __encode (size_t value, char* buffer)
+        {
+            return varint::encode(value, buffer);
+        }
+
+        template <typename _Tch>
+        static size_t __encode (size_t value, _Tch* buffer)
         {
             typedef decltype(std::declval<length_type>().value) underlying_t;
             
             const size_t window_length = CHAR_BIT * sizeof(_Tch) - 1;
             const underlying_t mask = (static_power<2, window_length>::value - 1);
             
-            SerializableSequence<underlying_t, _Tch> serializer;
-            serializer.value = 0;
-            underlying_t offset = 1;
-            _Tch buffer;
-            while ((buffer = stream.get()) & (mask + 1))
+            _Tch* ptr = buffer;
+            for (; value > mask; value >>= window_length)
             {
-                serializer.value += (buffer & mask) * offset;
-                offset *= static_power<2, window_length>::value;
+                *ptr++ = static_cast<_Tch>((value & mask) | (mask + 1));
             }
-            serializer.value += (buffer & mask) * offset;
-            x.value = serializer.value;
+            *ptr++ = static_cast<_Tch>(value);
+            return static_cast<size_t>(ptr - buffer);
+        }
+    };
+
+    /* Name of a binder in instrumentation reports. */
+    template <typename B>
+    struct binder_name
+    {
+        static const char* value ()
+        {
+            return "binder";
+        }
+    };
+
+    template <typename _St, typename _Order>
+    struct binder_name<sequence_binder<_St, _Order>>
+    {
+        static const char* value ()
+        {
+            return "sequence";
+        }
+    };
+
+    template <typename _St, typename _Order>
+    struct binder_name<struct_binder<_St, _Order>>
+    {
+        static const char* value ()
+        {
+            return "struct";
+        }
+    };
+
+    template <>
+    struct binder_name<indexed_binder>
+    {
+        static const char* value ()
+        {
+            return "indexed";
+        }
+    };
+
+    template <>
+    struct binder_name<tuple_binder>
+    {
+        static const char* value ()
+        {
+            return "tuple";
+        }
+    };
+
+    template <typename _Order>
+    struct binder_name<basic_trivial_binder<_Order>>
+    {
+        static const char* value ()
+        {
+            return "trivial";
+        }
+    };
+
+    template <>
+    struct binder_name<length_binder>
+    {
+        static const char* value ()
+        {
+            return "length";
+        }
+    };
+
+    /* The _Provider of composite_binder is an instrumentation hook when it
+     * declares a token_type: every binder call, nested ones included, is
+     * then bracketed by
+     *
+     *   token_type token = provider.enter(stream);
+     *   provider.template leave<Binder>(stream, token);
+     *
+     * Any other provider (e.g. mock) is ignored and costs nothing. A
+     * provider may be given as a reference type to share one collector. */
+    template <typename P>
+    struct is_instrumentation
+    {
+        template <typename A>
+        static std::true_type __test (typename A::token_type*);
+
+        template <typename A>
+        static std::false_type __test (...);
+
+        typedef decltype(__test<typename std::remove_reference<P>::type>(nullptr)) type;
+        static const bool value = type::value;
+    };
+
+    /* Brackets one binder call of composite_binder. S is the output
+     * stream on writes, the target on reads, where T is the input one. */
+    template <typename P, typename B, typename S, typename T, bool = is_instrumentation<P>::value>
+    struct binder_scope
+    {
+        binder_scope (P&, S&, T&) {}
+    };
+
+    template <typename P, typename B, typename S, typename T>
+    struct binder_scope<P, B, S, T, true>
+    {
+        typedef typename std::remove_reference<P>::type provider_t;
+        typedef typename std::conditional<is_output<S>::value, S, T>::type stream_t;
+
+        binder_scope (provider_t& provider, S& binding, T& x) : m_provider(provider), m_stream(__stream(binding, x, typename is_output<S>::type())), m_token(provider.enter(m_stream)) {}
+
+        ~binder_scope()
+        {
+            m_provider.template leave<B>(m_stream, m_token);
+        }
+
+        binder_scope (const binder_scope&) = delete;
+        binder_scope& operator= (const binder_scope&) = delete;
+    private:
+        static stream_t& __stream (S& binding, T&, std::true_type)
+        {
+            return binding;
+        }
+
+        static stream_t& __stream (S&, T& x, std::false_type)
+        {
             return x;
         }
+
+        provider_t& m_provider;
+        stream_t& m_stream;
+        typename provider_t::token_type m_token;
     };
 
     template <typename _Provider, typename _Binder, typename... _Binders>
@@ -335,14 +1023,18 @@ namespace data
         typename std::enable_if<__binder_index<size_t, 0, S, T, _Binder, _Binders...>::bindable, S&>::type
         operator() (S& binding, T&& x)
         {
-            std::get<__binder_index<size_t, 0, S, T, _Binder, _Binders...>::value>(m_binders)(binding, std::forward<T>(x));
+            static const size_t index = __binder_index<size_t, 0, S, T, _Binder, _Binders...>::value;
+            binder_scope<_Provider, typename std::tuple_element<index, stored_t>::type, S, typename std::remove_reference<T>::type> scope (m_provider, binding, x);
+            std::get<index>(m_binders)(binding, std::forward<T>(x));
             return binding;
         }
         template <typename S, typename T>
         typename std::enable_if<!__binder_index<size_t, 0, S, T, _Binder, _Binders...>::bindable, S&>::type
         operator() (S& binding, T&& x)
         {
-            std::get<__binder_index_w_callback<size_t, 0, this_type, S, T, _Binder, _Binders...>::value>(m_binders)(binding, std::forward<T>(x), *this);
+            static const size_t index = __binder_index_w_callback<size_t, 0, this_type, S, T, _Binder, _Binders...>::value;
+            binder_scope<_Provider, typename std::tuple_element<index, stored_t>::type, S, typename std::remove_reference<T>::type> scope (m_provider, binding, x);
+            std::get<index>(m_binders)(binding, std::forward<T>(x), *this);
             return binding;
         }
     protected:
@@ -355,6 +1047,8 @@ namespace data
         template <typename... Args>
         void operator()(Args&&...) {}
     };
+
+    typedef composite_binder<mock, tuple_binder, indexed_binder, struct_binder<length_type>, sequence_binder<length_type>, length_binder, trivial_binder> default_binder;
 };
 
 #endif	/* BASIC_BINDER_HPP */
@@ -0,0 +1,336 @@
+/*
+ * File:   byte_order.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 10:20 AM
+ */
+
+#ifndef BYTE_ORDER_HPP
+#define	BYTE_ORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace data
+{
+    struct byte_order
+    {
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && defined(__ORDER_LITTLE_ENDIAN__)
+        static constexpr bool is_big = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+#elif defined(_WIN32) || defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+        static constexpr bool is_big = false;
+#else
+#error "Unable to determine the byte order of the target platform"
+#endif
+        static constexpr bool is_little = !is_big;
+    };
+
+    template <size_t N>
+    struct swap_word;
+
+    template <>
+    struct swap_word<1>
+    {
+        typedef uint8_t type;
+
+        static type swap (type x)
+        {
+            return x;
+        }
+    };
+
+    template <>
+    struct swap_word<2>
+    {
+        typedef uint16_t type;
+
+        static type swap (type x)
+        {
+#if defined(_MSC_VER)
+            return _byteswap_ushort(x);
+#else
+            return __builtin_bswap16(x);
+#endif
+        }
+    };
+
+    template <>
+    struct swap_word<4>
+    {
+        typedef uint32_t type;
+
+        static type swap (type x)
+        {
+#if defined(_MSC_VER)
+            return _byteswap_ulong(x);
+#else
+            return __builtin_bswap32(x);
+#endif
+        }
+    };
+
+    template <>
+    struct swap_word<8>
+    {
+        typedef uint64_t type;
+
+        static type swap (type x)
+        {
+#if defined(_MSC_VER)
+            return _byteswap_uint64(x);
+#else
+            return __builtin_bswap64(x);
+#endif
+        }
+    };
+
+    template <typename T>
+    struct has_swap_word
+    {
+        typedef std::integral_constant<bool, sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8> type;
+        static const bool value = type::value;
+    };
+
+    template <typename T>
+    typename std::enable_if<has_swap_word<T>::value, T>::type byte_swap (T x)
+    {
+        typedef typename swap_word<sizeof(T)>::type word_t;
+
+        word_t word;
+        std::memcpy(&word, &x, sizeof(T));
+        word = swap_word<sizeof(T)>::swap(word);
+        std::memcpy(&x, &word, sizeof(T));
+        return x;
+    }
+
+    template <typename T>
+    typename std::enable_if<!has_swap_word<T>::value, T>::type byte_swap (T x)
+    {
+        unsigned char* begin = reinterpret_cast<unsigned char*>(&x);
+        for (unsigned char* end = begin + sizeof(T) - 1; begin < end; ++begin, --end)
+        {
+            unsigned char temp = *begin;
+            *begin = *end;
+            *end = temp;
+        }
+        return x;
+    }
+
+    namespace __byte_order
+    {
+        /* Shuffle masks reversing every N-byte word of a 32-byte block; the
+         * 16-byte kernels use the first half. */
+        template <size_t N>
+        struct shuffle_mask;
+
+        template <>
+        struct shuffle_mask<2>
+        {
+            static const unsigned char* value()
+            {
+                alignas(32) static const unsigned char mask [32] = {
+                    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                    1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14
+                };
+                return mask;
+            }
+        };
+
+        template <>
+        struct shuffle_mask<4>
+        {
+            static const unsigned char* value()
+            {
+                alignas(32) static const unsigned char mask [32] = {
+                    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                    3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12
+                };
+                return mask;
+            }
+        };
+
+        template <>
+        struct shuffle_mask<8>
+        {
+            static const unsigned char* value()
+            {
+                alignas(32) static const unsigned char mask [32] = {
+                    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8
+                };
+                return mask;
+            }
+        };
+
+        /* Swaps whole 16/32-byte blocks and returns the number of bytes done;
+         * the remainder is left to the scalar loop. */
+        template <size_t N>
+        inline size_t swap_blocks (unsigned char* ptr, size_t bytes)
+        {
+            size_t done = 0;
+#if defined(__AVX2__)
+            const __m256i mask256 = _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle_mask<N>::value()));
+            for (; done + 32 <= bytes; done += 32)
+            {
+                __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + done));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr + done), _mm256_shuffle_epi8(block, mask256));
+            }
+#endif
+#if defined(__AVX2__) || defined(__SSSE3__)
+            const __m128i mask128 = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffle_mask<N>::value()));
+            for (; done + 16 <= bytes; done += 16)
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + done));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + done), _mm_shuffle_epi8(block, mask128));
+            }
+#else
+            (void)ptr;
+            (void)bytes;
+#endif
+            return done;
+        }
+
+        template <typename T>
+        inline typename std::enable_if<sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8>::type
+        swap_n (T* first, size_t count)
+        {
+            typedef typename swap_word<sizeof(T)>::type word_t;
+
+            /* Word-wise through memcpy: the values may sit unaligned, e.g.
+             * in a sink window. */
+            unsigned char* ptr = reinterpret_cast<unsigned char*>(first);
+            size_t done = swap_blocks<sizeof(T)>(ptr, count * sizeof(T));
+            for (unsigned char* iter = ptr + done, *last = ptr + count * sizeof(T); iter != last; iter += sizeof(T))
+            {
+                word_t word;
+                std::memcpy(&word, iter, sizeof(T));
+                word = swap_word<sizeof(T)>::swap(word);
+                std::memcpy(iter, &word, sizeof(T));
+            }
+        }
+
+        template <typename T>
+        inline typename std::enable_if<sizeof(T) == 1>::type
+        swap_n (T*, size_t) {}
+
+        template <typename T>
+        inline typename std::enable_if<!has_swap_word<T>::value>::type
+        swap_n (T* first, size_t count)
+        {
+            for (T* last = first + count; first != last; ++first)
+            {
+                *first = byte_swap(*first);
+            }
+        }
+    };
+
+    /* Reverses the bytes of every element of [first, first + count). */
+    template <typename T>
+    void byte_swap (T* first, size_t count)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Swapped type must be trivially copyable");
+        __byte_order::swap_n(first, count);
+    }
+
+    template <typename T>
+    T to_big (T x)
+    {
+        return byte_order::is_big ? x : byte_swap(x);
+    }
+
+    template <typename T>
+    T to_little (T x)
+    {
+        return byte_order::is_little ? x : byte_swap(x);
+    }
+
+    template <typename T>
+    void to_big (T* first, size_t count)
+    {
+        if (!byte_order::is_big)
+        {
+            byte_swap(first, count);
+        }
+    }
+
+    template <typename T>
+    void to_little (T* first, size_t count)
+    {
+        if (!byte_order::is_little)
+        {
+            byte_swap(first, count);
+        }
+    }
+
+    /* Byte order of scalars on the wire, a policy of the binders writing
+     * them (trivial_binder, sequence_binder, struct_binder): whether the
+     * bytes of every multi-byte value are reversed on the way out and on
+     * the way in. The default wire is big-endian whatever the host. */
+    struct big_endian_wire
+    {
+        static constexpr bool reverse_on_write ()
+        {
+            return !byte_order::is_big;
+        }
+
+        static constexpr bool reverse_on_read ()
+        {
+            return !byte_order::is_big;
+        }
+    };
+
+    /* Little-endian whatever the host, the order native_binder writes on
+     * x86 and ARM; views of such a stream need it (see view.hpp). */
+    struct little_endian_wire
+    {
+        static constexpr bool reverse_on_write ()
+        {
+            return byte_order::is_big;
+        }
+
+        static constexpr bool reverse_on_read ()
+        {
+            return byte_order::is_big;
+        }
+    };
+
+    /* Host order: writes never reverse, reads only when told that the
+     * stream comes from a host of the other order (see native_binder). */
+    class native_wire
+    {
+    public:
+        native_wire () : m_reverse(false) {}
+
+        static constexpr bool reverse_on_write ()
+        {
+            return false;
+        }
+
+        bool reverse_on_read () const
+        {
+            return m_reverse;
+        }
+
+        void reverse_on_read (bool x)
+        {
+            m_reverse = x;
+        }
+    private:
+        bool m_reverse;
+    };
+};
+
+#endif	/* BYTE_ORDER_HPP */
+
@@ -0,0 +1,371 @@
+/*
+ * File:   compression.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 7:40 PM
+ */
+
+#ifndef COMPRESSION_HPP
+#define	COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "./basic_binder.hpp"
+#include "./sink.hpp"
+#include "./varint.hpp"
+
+/* Block compression stacked between a binder and its sink or source. The
+ * output is a sequence of independent blocks:
+ *
+ *   method (1 byte), raw length, stored length, stored bytes
+ *
+ * with varint lengths. Method 0 means the bytes are stored as they are,
+ * otherwise it is the id of the codec that packed them. Blocks share no
+ * state, so everything up to the last complete block of a truncated stream
+ * can still be read back.
+ *
+ * A codec provides an id, bound(n) (the most compress may write for n
+ * bytes), compress(data, n, out) returning the packed length, and
+ * decompress(data, n, out, length) which must fill exactly length bytes. */
+
+namespace data
+{
+    /* Stores every block unpacked: framing only. */
+    struct passthrough_codec
+    {
+        static const uint8_t id = 0;
+
+        static size_t bound (size_t n)
+        {
+            return n;
+        }
+
+        static size_t compress (const char*, size_t n, char*)
+        {
+            return n;
+        }
+
+        static void decompress (const char*, size_t, char*, size_t)
+        {
+            throw std::runtime_error("Passthrough blocks are never packed.");
+        }
+    };
+
+    /* Byte-oriented LZ77 in the spirit of LZ4: a sequence is a token with
+     * literal and match length nibbles (15 continues in 255-valued bytes),
+     * the literals, and a 16-bit little-endian distance back to a match of
+     * at least 4 bytes. The last sequence has literals only, and the last
+     * 5 bytes of a block are always literals. Matches are found through a
+     * single-entry hash table of 4-byte prefixes. */
+    struct lz_codec
+    {
+        static const uint8_t id = 1;
+
+        static size_t bound (size_t n)
+        {
+            return n + n / 255 + 16;
+        }
+
+        static size_t compress (const char* data, size_t n, char* out)
+        {
+            const uint8_t* first = reinterpret_cast<const uint8_t*>(data);
+            const uint8_t* last = first + n;
+            const uint8_t* anchor = first;
+            uint8_t* cursor = reinterpret_cast<uint8_t*>(out);
+
+            if (n > __min_block)
+            {
+                std::vector<uint32_t> table (size_t(1) << __hash_bits, 0);
+                const uint8_t* match_limit = last - __last_literals;
+                const uint8_t* limit = last - __min_block;
+                const uint8_t* iter = first + 1;
+                while (iter < limit)
+                {
+                    uint32_t& slot = table[__hash(__load32(iter))];
+                    const uint8_t* candidate = first + slot;
+                    slot = static_cast<uint32_t>(iter - first);
+                    if (candidate >= iter || iter - candidate > __max_distance || __load32(candidate) != __load32(iter))
+                    {
+                        iter += 1 + (static_cast<size_t>(iter - anchor) >> 6);
+                        continue;
+                    }
+                    while (iter > anchor && candidate > first && iter[-1] == candidate[-1])
+                    {
+                        --iter;
+                        --candidate;
+                    }
+                    const uint8_t* end = iter + __min_match;
+                    for (const uint8_t* source = candidate + __min_match; end < match_limit && *end == *source; ++end, ++source);
+                    cursor = __sequence(cursor, anchor, iter, static_cast<size_t>(iter - candidate), static_cast<size_t>(end - iter));
+                    iter = anchor = end;
+                    if (iter < limit)
+                    {
+                        table[__hash(__load32(iter - 2))] = static_cast<uint32_t>(iter - 2 - first);
+                    }
+                }
+            }
+            cursor = __sequence(cursor, anchor, last, 0, 0);
+            return static_cast<size_t>(reinterpret_cast<char*>(cursor) - out);
+        }
+
+        static void decompress (const char* data, size_t n, char* out, size_t length)
+        {
+            const uint8_t* iter = reinterpret_cast<const uint8_t*>(data);
+            const uint8_t* last = iter + n;
+            uint8_t* first = reinterpret_cast<uint8_t*>(out);
+            uint8_t* cursor = first;
+            uint8_t* end = first + length;
+            while (true)
+            {
+                if (iter == last)
+                {
+                    __corrupted();
+                }
+                const uint8_t token = *iter++;
+                size_t literals = __read_length(iter, last, token >> 4);
+                if (literals > static_cast<size_t>(last - iter) || literals > static_cast<size_t>(end - cursor))
+                {
+                    __corrupted();
+                }
+                std::memcpy(cursor, iter, literals);
+                cursor += literals;
+                iter += literals;
+                if (iter == last)
+                {
+                    break;
+                }
+                if (last - iter < 2)
+                {
+                    __corrupted();
+                }
+                size_t distance = iter[0] | (static_cast<size_t>(iter[1]) << 8);
+                iter += 2;
+                size_t match = __read_length(iter, last, token & 15) + __min_match;
+                if (distance == 0 || distance > static_cast<size_t>(cursor - first) || match > static_cast<size_t>(end - cursor))
+                {
+                    __corrupted();
+                }
+                const uint8_t* source = cursor - distance;
+                if (distance >= match)
+                {
+                    std::memcpy(cursor, source, match);
+                    cursor += match;
+                }
+                else
+                {
+                    for (uint8_t* stop = cursor + match; cursor != stop; *cursor++ = *source++);
+                }
+            }
+            if (cursor != end)
+            {
+                __corrupted();
+            }
+        }
+    private:
+        static const unsigned __hash_bits = 12;
+        static const size_t __min_match = 4;
+        static const size_t __last_literals = 5;
+        static const size_t __min_block = 12;
+        static const ptrdiff_t __max_distance = 0xffff;
+
+        static uint32_t __load32 (const uint8_t* data)
+        {
+            uint32_t x;
+            std::memcpy(&x, data, sizeof(x));
+            return x;
+        }
+
+        static uint32_t __hash (uint32_t x)
+        {
+            return (x * 2654435761u) >> (32 - __hash_bits);
+        }
+
+        static uint8_t* __write_length (uint8_t* cursor, size_t x)
+        {
+            for (; x >= 255; x -= 255)
+            {
+                *cursor++ = 255;
+            }
+            *cursor++ = static_cast<uint8_t>(x);
+            return cursor;
+        }
+
+        static size_t __read_length (const uint8_t*& iter, const uint8_t* last, size_t x)
+        {
+            if (x != 15)
+            {
+                return x;
+            }
+            uint8_t chunk;
+            do
+            {
+                if (iter == last)
+                {
+                    __corrupted();
+                }
+                chunk = *iter++;
+                x += chunk;
+            }
+            while (chunk == 255);
+            return x;
+        }
+
+        /* Literals [first, last) followed by a match, if match > 0. */
+        static uint8_t* __sequence (uint8_t* cursor, const uint8_t* first, const uint8_t* last, size_t distance, size_t match)
+        {
+            size_t literals = static_cast<size_t>(last - first);
+            size_t extra = match > 0 ? match - __min_match : 0;
+            uint8_t* token = cursor++;
+            *token = static_cast<uint8_t>((std::min<size_t>(literals, 15) << 4) | std::min<size_t>(extra, 15));
+            if (literals >= 15)
+            {
+                cursor = __write_length(cursor, literals - 15);
+            }
+            std::memcpy(cursor, first, literals);
+            cursor += literals;
+            if (match > 0)
+            {
+                *cursor++ = static_cast<uint8_t>(distance);
+                *cursor++ = static_cast<uint8_t>(distance >> 8);
+                if (extra >= 15)
+                {
+                    cursor = __write_length(cursor, extra - 15);
+                }
+            }
+            return cursor;
+        }
+
+        static void __corrupted ()
+        {
+            throw std::runtime_error("Corrupted compressed block.");
+        }
+    };
+
+    /* Cuts everything written into blocks of block_length bytes and writes
+     * them packed by Codec to target; a block that does not shrink is
+     * stored. flush() closes the current block and flushes the target. */
+    template <typename Codec = lz_codec>
+    class compressing_sink : public buffered_sink
+    {
+    public:
+        static const size_t default_block_length = 64 * 1024;
+
+        explicit compressing_sink (basic_sink& target, size_t block_length = default_block_length) : buffered_sink(block_length), m_target(target), m_block_length(block_length), m_packed(Codec::bound(block_length)) {}
+
+        ~compressing_sink()
+        {
+            try
+            {
+                __drain();
+            }
+            catch (const std::exception&) {}
+        }
+    protected:
+        void drain (const char_type* data, size_t n)
+        {
+            for (size_t step; n > 0; n -= step, data += step)
+            {
+                step = std::min(n, m_block_length);
+                __block(data, step);
+            }
+        }
+
+        void sync ()
+        {
+            __drain();
+            m_target.flush();
+        }
+    private:
+        void __block (const char_type* data, size_t n)
+        {
+            size_t packed = Codec::id != 0 ? Codec::compress(data, n, &m_packed[0]) : n;
+            const bool stored = packed >= n;
+            const char_type* payload = stored ? data : &m_packed[0];
+            size_t length = stored ? n : packed;
+
+            char_type* header = m_target.reserve(1 + 2 * varint::max_length);
+            char_type* cursor = header;
+            *cursor++ = static_cast<char_type>(stored ? 0 : Codec::id);
+            cursor += varint::encode(n, cursor);
+            cursor += varint::encode(length, cursor);
+            m_target.commit(static_cast<size_t>(cursor - header));
+            m_target.write(payload, length);
+        }
+
+        basic_sink& m_target;
+        size_t m_block_length;
+        std::vector<char_type> m_packed;
+    };
+
+    /* Reads the blocks written by compressing_sink<Codec> from origin. A
+     * block packed by a different codec, or longer than max_block_length,
+     * throws std::runtime_error. */
+    template <typename Codec = lz_codec>
+    class decompressing_source : public buffered_source
+    {
+    public:
+        static const size_t max_block_length = 64 * 1024 * 1024;
+
+        explicit decompressing_source (basic_source& origin, size_t capacity = default_capacity) : buffered_source(capacity), m_origin(origin), m_block(), m_position(0) {}
+    protected:
+        size_t fill (char_type* data, size_t n)
+        {
+            if (m_position == m_block.size() && !__next())
+            {
+                return 0;
+            }
+            n = std::min(n, m_block.size() - m_position);
+            std::memcpy(data, &m_block[m_position], n);
+            m_position += n;
+            return n;
+        }
+    private:
+        bool __next ()
+        {
+            if (m_origin.eof())
+            {
+                return false;
+            }
+            const uint8_t method = static_cast<uint8_t>(m_origin.get());
+            length_binder binder;
+            length_type length {};
+            length_type stored {};
+            binder(length, m_origin);
+            binder(stored, m_origin);
+            /* The stored length is checked before require(), which would
+             * otherwise buffer whatever a corrupted header asks for. */
+            if (length.value > max_block_length || (method != 0 && method != Codec::id) || (method == 0 && stored.value != length.value)
+                    || (method != 0 && stored.value > Codec::bound(length.value)))
+            {
+                throw std::runtime_error("Unsupported compressed block.");
+            }
+            m_block.resize(length.value);
+            m_position = 0;
+            const char_type* payload = m_origin.require(stored.value);
+            if (length.value > 0)
+            {
+                if (method == 0)
+                {
+                    std::memcpy(&m_block[0], payload, length.value);
+                }
+                else
+                {
+                    Codec::decompress(payload, stored.value, &m_block[0], length.value);
+                }
+            }
+            m_origin.consume(stored.value);
+            return true;
+        }
+
+        basic_source& m_origin;
+        std::vector<char_type> m_block;
+        size_t m_position;
+    };
+};
+
+#endif	/* COMPRESSION_HPP */
+
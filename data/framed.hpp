@@ -0,0 +1,346 @@
+/*
+ * File:   framed.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 7:00 PM
+ */
+
+#ifndef FRAMED_HPP
+#define	FRAMED_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include "./basic_binder.hpp"
+#include "./sink.hpp"
+#include "./thread_pool.hpp"
+
+/* Framed layout of a top-level container, cut into chunks that can be
+ * encoded and decoded independently:
+ *
+ *   element count, chunk count
+ *   per chunk: byte length, then the chunk as sequence_binder writes it
+ *              (element count and elements)
+ *
+ * Counts and lengths are length_binder varints. The layout does not depend
+ * on how many threads wrote it. */
+
+namespace data
+{
+    struct framed_format
+    {
+        /* Elements per chunk unless the caller says otherwise. */
+        static const size_t default_chunk_length = 16 * 1024;
+    };
+
+    namespace __framed
+    {
+        template <typename C>
+        auto count (const C& x, int) -> decltype(static_cast<size_t>(x.size()))
+        {
+            return static_cast<size_t>(x.size());
+        }
+
+        template <typename C>
+        size_t count (const C& x, long)
+        {
+            return static_cast<size_t>(std::distance(std::begin(x), std::end(x)));
+        }
+
+        template <typename B, typename S>
+        void write_length (B& binder, S& stream, size_t x)
+        {
+            length_type length {x};
+            binder(stream, length);
+        }
+
+        template <typename B, typename S>
+        size_t read_length (B& binder, S& stream)
+        {
+            length_type length {};
+            binder(length, stream);
+            return length.value;
+        }
+
+        /* Count and elements of one chunk, i.e. its sequence encoding. */
+        template <typename B, typename I>
+        std::string encode_chunk (I first, size_t length)
+        {
+            std::string result;
+            {
+                string_sink sink (result);
+                B binder;
+                write_length(binder, sink, length);
+                for (; length > 0; --length, ++first)
+                {
+                    binder(sink, *first);
+                }
+            }
+            return result;
+        }
+
+        template <typename B, typename S>
+        void write_chunk (B& binder, S& stream, const std::string& chunk)
+        {
+            write_length(binder, stream, chunk.size());
+            stream.write(chunk.data(), chunk.size());
+        }
+
+        template <typename _Tch, typename _Ttr>
+        bool good (const std::basic_istream<_Tch, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        inline bool good (const basic_source&)
+        {
+            return true;
+        }
+
+        /* Capacity to reserve for an element count read from the stream,
+         * before any chunk has been checked: a source cannot hold more
+         * elements than bytes, and an istream gets one chunk's worth. */
+        template <typename _Tch, typename _Ttr>
+        size_t capacity (size_t length, const std::basic_istream<_Tch, _Ttr>&)
+        {
+            const size_t chunk = framed_format::default_chunk_length;
+            return std::min(length, chunk);
+        }
+
+        inline size_t capacity (size_t length, const basic_source& source)
+        {
+            return std::min(length, source.available());
+        }
+
+        template <size_t N>
+        struct rank : public rank<N - 1> {};
+
+        template <>
+        struct rank<0> {};
+
+        template <typename C>
+        auto reserve (C& x, size_t length, int) -> decltype(x.reserve(length), void())
+        {
+            x.reserve(length);
+        }
+
+        template <typename C>
+        void reserve (C&, size_t, long) {}
+
+        /* Lists take the nodes of a partial result as they are. */
+        template <typename C>
+        auto merge (C& x, C& part, rank<3>) -> decltype(x.splice(x.end(), part), void())
+        {
+            x.splice(x.end(), part);
+        }
+
+        /* Associative containers relink node handles (C++17); the parts
+         * come in key order, so the end hint makes every insert O(1). */
+        template <typename C>
+        auto merge (C& x, C& part, rank<2>) -> decltype(x.insert(x.end(), part.extract(part.begin())), void())
+        {
+            while (!part.empty())
+            {
+                x.insert(x.end(), part.extract(part.begin()));
+            }
+        }
+
+        /* Contiguous containers move the whole part into reserved space. */
+        template <typename C>
+        auto merge (C& x, C& part, rank<1>) -> decltype(x.insert(x.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end())), void())
+        {
+            x.insert(x.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        }
+
+        template <typename C>
+        void merge (C& x, C& part, rank<0>)
+        {
+            for (auto iter = part.begin(); iter != part.end(); ++iter)
+            {
+                x.insert(x.end(), std::move(*iter));
+            }
+        }
+
+        template <typename B, typename C>
+        C decode_chunk (const char* data, size_t length)
+        {
+            span_source source (data, length);
+            B binder;
+            C part;
+            binder(part, source);
+            return part;
+        }
+    };
+
+    /* Framed encoding on the calling thread. */
+    template <typename B = default_binder, typename S, typename C>
+    S& write_framed (S& stream, const C& x, size_t chunk_length = framed_format::default_chunk_length)
+    {
+        chunk_length = std::max<size_t>(chunk_length, 1);
+        B binder;
+        size_t length = __framed::count(x, 0);
+        __framed::write_length(binder, stream, length);
+        __framed::write_length(binder, stream, (length + chunk_length - 1) / chunk_length);
+        auto iter = std::begin(x);
+        for (size_t left = length, step; left > 0; left -= step)
+        {
+            step = std::min(left, chunk_length);
+            __framed::write_chunk(binder, stream, __framed::encode_chunk<B>(iter, step));
+            std::advance(iter, step);
+        }
+        return stream;
+    }
+
+    /* Chunks are encoded on the pool and written in order as they complete.
+     * At most two chunks per worker are in flight, which bounds the memory
+     * held beyond x itself; x must not change until this returns. */
+    template <typename B = default_binder, typename S, typename C>
+    S& write_framed (thread_pool& pool, S& stream, const C& x, size_t chunk_length = framed_format::default_chunk_length)
+    {
+        typedef decltype(std::begin(x)) iterator_t;
+
+        chunk_length = std::max<size_t>(chunk_length, 1);
+        B binder;
+        size_t length = __framed::count(x, 0);
+        __framed::write_length(binder, stream, length);
+        __framed::write_length(binder, stream, (length + chunk_length - 1) / chunk_length);
+
+        const size_t window = 2 * pool.size();
+        std::deque<std::future<std::string>> pending;
+        iterator_t iter = std::begin(x);
+        size_t left = length;
+        try
+        {
+            while (left > 0 || !pending.empty())
+            {
+                for (size_t step; left > 0 && pending.size() < window; left -= step)
+                {
+                    step = std::min(left, chunk_length);
+                    iterator_t first = iter;
+                    pending.push_back(pool.submit([first, step] () { return __framed::encode_chunk<B>(first, step); }));
+                    std::advance(iter, step);
+                }
+                std::string chunk = pending.front().get();
+                pending.pop_front();
+                __framed::write_chunk(binder, stream, chunk);
+            }
+        }
+        catch (...)
+        {
+            for (std::future<std::string>& chunk : pending)
+            {
+                if (chunk.valid())
+                {
+                    chunk.wait();
+                }
+            }
+            throw;
+        }
+        return stream;
+    }
+
+    /* Decodes a framed container on the calling thread; on a std::istream
+     * decoding stops at the first failure with the chunks read so far. */
+    template <typename B = default_binder, typename C, typename S>
+    C& read_framed (C& x, S& stream)
+    {
+        B binder;
+        x.clear();
+        const size_t elements = __framed::read_length(binder, stream);
+        __framed::reserve(x, __framed::capacity(elements, stream), 0);
+        for (size_t chunks = __framed::read_length(binder, stream); chunks > 0 && __framed::good(stream); --chunks)
+        {
+            __framed::read_length(binder, stream);
+            C part;
+            binder(part, stream);
+            if (!__framed::good(stream))
+            {
+                break;
+            }
+            __framed::merge(x, part, __framed::rank<3>());
+        }
+        return x;
+    }
+
+    namespace __framed
+    {
+        /* Frames are handed to the pool as they are located, at most two
+         * per worker ahead of the merge. A stable source keeps every byte it
+         * has shown addressable, so frames are decoded in place; otherwise
+         * each frame is copied out first. */
+        template <typename B, typename C>
+        C& read_framed (thread_pool& pool, C& x, basic_source& source, bool stable)
+        {
+            B binder;
+            x.clear();
+            const size_t elements = read_length(binder, source);
+            reserve(x, capacity(elements, source), 0);
+            size_t chunks = read_length(binder, source);
+
+            const size_t window = 2 * pool.size();
+            std::deque<std::future<C>> pending;
+            try
+            {
+                while (chunks > 0 || !pending.empty())
+                {
+                    for (; chunks > 0 && pending.size() < window; --chunks)
+                    {
+                        size_t length = read_length(binder, source);
+                        const char* data = source.require(length);
+                        if (stable)
+                        {
+                            pending.push_back(pool.submit([data, length] () { return decode_chunk<B, C>(data, length); }));
+                        }
+                        else
+                        {
+                            std::shared_ptr<std::string> frame (new std::string(data, length));
+                            pending.push_back(pool.submit([frame] () { return decode_chunk<B, C>(frame->data(), frame->size()); }));
+                        }
+                        source.consume(length);
+                    }
+                    C part = pending.front().get();
+                    pending.pop_front();
+                    merge(x, part, rank<3>());
+                }
+            }
+            catch (...)
+            {
+                for (std::future<C>& part : pending)
+                {
+                    if (part.valid())
+                    {
+                        part.wait();
+                    }
+                }
+                throw;
+            }
+            return x;
+        }
+    };
+
+    /* Decodes the frames on the pool into partial containers and merges
+     * them into x in order: lists are spliced, maps and sets relink node
+     * handles under C++17, vectors move each part into storage reserved
+     * for the whole container. Frames of a span_source (e.g. over a
+     * mapped_file) are decoded in place. */
+    template <typename B = default_binder, typename C>
+    C& read_framed (thread_pool& pool, C& x, span_source& source)
+    {
+        return __framed::read_framed<B>(pool, x, source, true);
+    }
+
+    template <typename B = default_binder, typename C>
+    C& read_framed (thread_pool& pool, C& x, basic_source& source)
+    {
+        return __framed::read_framed<B>(pool, x, source, false);
+    }
+};
+
+#endif	/* FRAMED_HPP */
+
@@ -0,0 +1,224 @@
+/*
+ * File:   instrumentation.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 12:45 AM
+ */
+
+#ifndef INSTRUMENTATION_HPP
+#define	INSTRUMENTATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+#include "./basic_binder.hpp"
+#include "./varint.hpp"
+
+/* Profiling provider for composite_binder, see is_instrumentation:
+ *
+ *   data::binder_profile profile;
+ *   data::with_provider<data::default_binder, data::binder_profile&>::type binder (profile);
+ *   binder(sink, x);
+ *   profile.report(std::cerr);
+ *
+ * Cycles are inclusive of nested binder calls; self cycles leave them out
+ * (the bookkeeping of a nested call still counts toward its parent). */
+
+namespace data
+{
+    /* Time stamp counter where there is one, nanoseconds otherwise. */
+    inline uint64_t cycle_count ()
+    {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /* The same composite_binder with another provider. */
+    template <typename B, typename P>
+    struct with_provider;
+
+    template <typename _Provider, typename... _Binders, typename P>
+    struct with_provider<composite_binder<_Provider, _Binders...>, P>
+    {
+        typedef composite_binder<P, _Binders...> type;
+    };
+
+    class binder_profile
+    {
+    public:
+        static const size_t buckets = 48;
+
+        /* Totals of one binder at one nesting depth (0 is the outermost
+         * call) in one direction; histogram[i] counts the calls that took
+         * [2^i, 2^(i+1)) cycles (the first also takes 0). */
+        struct entry
+        {
+            const char* binder;
+            size_t depth;
+            bool output;
+            uint64_t calls;
+            uint64_t bytes;
+            uint64_t cycles;
+            uint64_t self;
+            uint64_t histogram [buckets];
+        };
+
+        struct token_type
+        {
+            uint64_t start;
+            size_t position;
+        };
+
+        template <typename S>
+        token_type enter (S& stream)
+        {
+            m_children.push_back(0);
+            token_type token;
+            token.position = __position(stream);
+            token.start = cycle_count();
+            return token;
+        }
+
+        template <typename B, typename S>
+        void leave (S& stream, const token_type& token)
+        {
+            const uint64_t cycles = cycle_count() - token.start;
+            const size_t position = __position(stream);
+            const uint64_t children = m_children.back();
+            m_children.pop_back();
+            if (!m_children.empty())
+            {
+                m_children.back() += cycles;
+            }
+            entry& target = __entry(binder_name<B>::value(), m_children.size(), is_output<S>::value);
+            ++target.calls;
+            target.bytes += position >= token.position ? position - token.position : 0;
+            target.cycles += cycles;
+            target.self += cycles >= children ? cycles - children : 0;
+            ++target.histogram[std::min<size_t>(buckets - 1, __log2(cycles))];
+        }
+
+        /* Entries by direction, binder and depth. */
+        std::vector<entry> entries () const
+        {
+            std::vector<entry> result;
+            for (auto iter = m_entries.begin(); iter != m_entries.end(); ++iter)
+            {
+                result.push_back(iter->second);
+            }
+            return result;
+        }
+
+        void clear ()
+        {
+            m_entries.clear();
+            m_children.clear();
+        }
+
+        /* A table of the entries followed by the histogram of every binder
+         * over all depths, one bar per power of two. */
+        std::ostream& report (std::ostream& out) const
+        {
+            out << std::left << std::setw(6) << "dir" << std::setw(10) << "binder" << std::right << std::setw(6) << "depth"
+                    << std::setw(12) << "calls" << std::setw(14) << "bytes" << std::setw(16) << "cycles"
+                    << std::setw(16) << "self" << std::setw(12) << "cyc/call" << std::endl;
+            std::map<std::tuple<bool, std::string>, std::vector<uint64_t>> totals;
+            for (auto iter = m_entries.begin(); iter != m_entries.end(); ++iter)
+            {
+                const entry& x = iter->second;
+                out << std::left << std::setw(6) << (x.output ? "write" : "read") << std::setw(10) << x.binder << std::right << std::setw(6) << x.depth
+                        << std::setw(12) << x.calls << std::setw(14) << x.bytes << std::setw(16) << x.cycles
+                        << std::setw(16) << x.self << std::setw(12) << x.cycles / std::max<uint64_t>(x.calls, 1) << std::endl;
+                std::vector<uint64_t>& histogram = totals[std::make_tuple(!x.output, std::string(x.binder))];
+                histogram.resize(buckets);
+                for (size_t i = 0; i < buckets; ++i)
+                {
+                    histogram[i] += x.histogram[i];
+                }
+            }
+            for (auto iter = totals.begin(); iter != totals.end(); ++iter)
+            {
+                const std::vector<uint64_t>& histogram = iter->second;
+                const uint64_t peak = *std::max_element(histogram.begin(), histogram.end());
+                out << std::endl << (std::get<0>(iter->first) ? "read " : "write ") << std::get<1>(iter->first) << ", cycles per call:" << std::endl;
+                for (size_t i = 0; i < buckets; ++i)
+                {
+                    if (histogram[i] > 0)
+                    {
+                        out << std::right << std::setw(12) << (uint64_t(1) << i) << " | " << std::left
+                                << std::setw(40) << std::string(static_cast<size_t>((histogram[i] * 40 + peak - 1) / peak), '#')
+                                << " " << histogram[i] << std::endl;
+                    }
+                }
+            }
+            return out;
+        }
+    private:
+        static size_t __log2 (uint64_t x)
+        {
+            return x > 1 ? 63 - static_cast<size_t>(varint::count_leading_zeros(x)) : 0;
+        }
+
+        static size_t __position (const basic_sink& stream)
+        {
+            return stream.size();
+        }
+
+        static size_t __position (const basic_source& stream)
+        {
+            return stream.position();
+        }
+
+        template <typename _Tch, typename _Ttr>
+        static size_t __position (std::basic_ostream<_Tch, _Ttr>& stream)
+        {
+            const std::streamoff position = stream.good() ? std::streamoff(stream.tellp()) : 0;
+            return position > 0 ? static_cast<size_t>(position) : 0;
+        }
+
+        template <typename _Tch, typename _Ttr>
+        static size_t __position (std::basic_istream<_Tch, _Ttr>& stream)
+        {
+            const std::streamoff position = stream.good() ? std::streamoff(stream.tellg()) : 0;
+            return position > 0 ? static_cast<size_t>(position) : 0;
+        }
+
+        template <typename S>
+        static typename std::enable_if<!is_output<S>::value && !is_input<S>::value, size_t>::type __position (S&)
+        {
+            return 0;
+        }
+
+        entry& __entry (const char* binder, size_t depth, bool output)
+        {
+            entry& result = m_entries[std::make_tuple(!output, std::string(binder), depth)];
+            if (result.binder == nullptr)
+            {
+                result.binder = binder;
+                result.depth = depth;
+                result.output = output;
+            }
+            return result;
+        }
+
+        std::map<std::tuple<bool, std::string, size_t>, entry> m_entries;
+        std::vector<uint64_t> m_children;
+    };
+};
+
+#endif	/* INSTRUMENTATION_HPP */
+
@@ -0,0 +1,268 @@
+/*
+ * File:   interning_binder.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 5:15 AM
+ */
+
+#ifndef INTERNING_BINDER_HPP
+#define	INTERNING_BINDER_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "./basic_binder.hpp"
+#include "./sink.hpp"
+
+namespace data
+{
+    /* Strings the string table applies to: std::string, and on decode
+     * std::shared_ptr<const std::string> to share the table's copy. */
+    template <typename T>
+    struct is_interned
+    {
+        typedef typename std::decay<T>::type type_t;
+
+        typedef std::integral_constant<bool, std::is_same<type_t, std::string>::value || std::is_same<type_t, std::shared_ptr<const std::string>>::value> type;
+        static const bool value = type::value;
+    };
+
+    /* Strings numbered in the order they first appear in a stream; repeats
+     * are written as back-references:
+     *
+     *   tag (varint), then for a tag of 0 the string as sequence_binder
+     *   writes it; a tag n > 0 repeats string n - 1
+     *
+     * Strings longer than MaxLength are written in full every time and get
+     * no number. Both sides keep a table of the strings seen so far, so a
+     * binder serves one stream at a time; reset() starts over. A repeat
+     * decodes without reading the string again, and into a
+     * std::shared_ptr<const std::string> without copying it (a null one is
+     * written as an empty string). Opt in by listing it before
+     * sequence_binder, see interning_binder. */
+    template <size_t MaxLength = 256>
+    class string_table_binder
+    {
+    public:
+        static const size_t max_length = MaxLength;
+
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_interned<T>::value && sizeof(typename S::char_type) == 1, S&>::type
+        operator() (S& stream, T&& x, Cb&& callback)
+        {
+            const std::string& value = __value(x);
+            length_type tag {0};
+            if (value.size() <= max_length)
+            {
+                const size_t hash = std::hash<std::string>()(value);
+                tag.value = __find(value, hash);
+                if (tag.value != 0)
+                {
+                    callback(stream, tag);
+                    return stream;
+                }
+                __insert(value, hash);
+            }
+            callback(stream, tag);
+            m_sequence(stream, value, callback);
+            return stream;
+        }
+
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_interned<T>::value && sizeof(typename S::char_type) == 1, T&>::type
+        operator() (T& x, S& stream, Cb&& callback)
+        {
+            length_type tag {0};
+            callback(tag, stream);
+            if (!__good(stream))
+            {
+                return x;
+            }
+            if (tag.value == 0)
+            {
+                __read(x, stream, callback);
+            }
+            else if (tag.value <= m_entries.size())
+            {
+                __assign(x, m_entries[tag.value - 1]);
+            }
+            else
+            {
+                __fail(stream);
+            }
+            return x;
+        }
+
+        /* Forgets the strings seen so far. */
+        void reset ()
+        {
+            m_strings.clear();
+            m_hashes.clear();
+            m_slots.clear();
+            m_entries.clear();
+        }
+    private:
+        typedef std::shared_ptr<const std::string> entry_t;
+
+        /* The written strings are found through an open-addressed table of
+         * their numbers plus one (0 marks a free slot), kept at most half
+         * full; a std::unordered_map lookup costs a node and a division. */
+        size_t __find (const std::string& x, size_t hash) const
+        {
+            const size_t mask = m_slots.size() - 1;
+            for (size_t i = hash & mask; !m_slots.empty(); i = (i + 1) & mask)
+            {
+                const size_t slot = m_slots[i];
+                if (slot == 0)
+                {
+                    break;
+                }
+                if (m_hashes[slot - 1] == hash && m_strings[slot - 1] == x)
+                {
+                    return slot;
+                }
+            }
+            return 0;
+        }
+
+        void __insert (const std::string& x, size_t hash)
+        {
+            m_strings.push_back(x);
+            m_hashes.push_back(hash);
+            if (2 * m_strings.size() <= m_slots.size())
+            {
+                __place(m_strings.size() - 1);
+                return;
+            }
+            m_slots.assign(std::max<size_t>(2 * m_slots.size(), 16), 0);
+            for (size_t id = 0; id < m_strings.size(); ++id)
+            {
+                __place(id);
+            }
+        }
+
+        void __place (size_t id)
+        {
+            const size_t mask = m_slots.size() - 1;
+            size_t i = m_hashes[id] & mask;
+            while (m_slots[i] != 0)
+            {
+                i = (i + 1) & mask;
+            }
+            m_slots[i] = id + 1;
+        }
+
+        static const std::string& __value (const std::string& x)
+        {
+            return x;
+        }
+
+        static const std::string& __value (const entry_t& x)
+        {
+            static const std::string empty;
+            return x ? *x : empty;
+        }
+
+        template <typename S, typename Cb>
+        void __read (std::string& x, S& stream, Cb&& callback)
+        {
+            m_sequence(x, stream, callback);
+            if (__good(stream) && x.size() <= max_length)
+            {
+                m_entries.push_back(std::make_shared<const std::string>(x));
+            }
+        }
+
+        template <typename S, typename Cb>
+        void __read (entry_t& x, S& stream, Cb&& callback)
+        {
+            std::string value;
+            m_sequence(value, stream, callback);
+            x = std::make_shared<const std::string>(std::move(value));
+            if (__good(stream) && x->size() <= max_length)
+            {
+                m_entries.push_back(x);
+            }
+        }
+
+        static void __assign (std::string& x, const entry_t& entry)
+        {
+            x.assign(*entry);
+        }
+
+        static void __assign (entry_t& x, const entry_t& entry)
+        {
+            x = entry;
+        }
+
+        template <typename _Ttr>
+        static bool __good (const std::basic_istream<char, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+
+        template <typename _Ttr>
+        static void __fail (std::basic_istream<char, _Ttr>& stream)
+        {
+            stream.setstate(std::ios_base::failbit);
+        }
+
+        static void __fail (basic_source&)
+        {
+            throw std::runtime_error("String back-reference out of range.");
+        }
+
+        sequence_binder<length_type> m_sequence;
+        std::vector<std::string> m_strings;
+        std::vector<size_t> m_hashes;
+        std::vector<size_t> m_slots;
+        std::vector<entry_t> m_entries;
+    };
+
+    template <size_t MaxLength>
+    struct binder_name<string_table_binder<MaxLength>>
+    {
+        static const char* value ()
+        {
+            return "strings";
+        }
+    };
+
+    /* default_binder with interned strings. */
+    template <typename _Provider = mock, size_t MaxLength = 256>
+    class basic_interning_binder : public composite_binder<_Provider, tuple_binder, indexed_binder, struct_binder<length_type>, string_table_binder<MaxLength>,
+            sequence_binder<length_type>, length_binder, trivial_binder>
+    {
+        typedef composite_binder<_Provider, tuple_binder, indexed_binder, struct_binder<length_type>, string_table_binder<MaxLength>,
+                sequence_binder<length_type>, length_binder, trivial_binder> base_t;
+    public:
+        basic_interning_binder () : base_t() {}
+
+        template <typename P, typename = typename std::enable_if<!std::is_same<typename std::decay<P>::type, basic_interning_binder>::value>::type>
+        explicit basic_interning_binder (P&& provider) : base_t(std::forward<P>(provider)) {}
+
+        /* Starts a new stream. */
+        void reset ()
+        {
+            std::get<3>(this->m_binders).reset();
+        }
+    };
+
+    typedef basic_interning_binder<> interning_binder;
+};
+
+#endif	/* INTERNING_BINDER_HPP */
+
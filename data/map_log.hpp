@@ -0,0 +1,570 @@
+/*
+ * File:   map_log.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 4:10 AM
+ */
+
+#ifndef MAP_LOG_HPP
+#define	MAP_LOG_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./mapped_file.hpp"
+#include "./sink.hpp"
+#include "./varint.hpp"
+
+/* Append-only log of an associative container:
+ *
+ *   header   magic
+ *   records  kind (1 byte), payload length, payload, checksum
+ *
+ * with a varint length and a 32-bit big-endian FNV-1a checksum of kind and
+ * payload. Payloads are binder encodings:
+ *
+ *   snapshot  the whole container
+ *   insert    key, value (the key was absent)
+ *   update    key, value (the key was present)
+ *   erase     key
+ *
+ * Replay applies the records in order; a snapshot replaces everything
+ * before it. A record that runs past the end of the file or fails its
+ * checksum is a torn write: replay stops in front of it, and map_log cuts
+ * it off before appending. */
+
+namespace data
+{
+    struct map_log_format
+    {
+        static const size_t header_length = 8;
+        static const size_t checksum_length = 4;
+
+        static const char snapshot = 'S';
+        static const char insert = 'I';
+        static const char update = 'U';
+        static const char erase = 'E';
+
+        static const char* magic ()
+        {
+            return "SOXLOG01";
+        }
+
+        static uint32_t checksum (char kind, const char* data, size_t length)
+        {
+            uint32_t result = __step(2166136261u, static_cast<unsigned char>(kind));
+            for (const char* last = data + length; data != last; ++data)
+            {
+                result = __step(result, static_cast<unsigned char>(*data));
+            }
+            return result;
+        }
+
+        /* Writes one record and returns its length. */
+        static size_t write (basic_sink& sink, char kind, const std::string& payload)
+        {
+            char* head = sink.reserve(1 + varint::max_length);
+            head[0] = kind;
+            const size_t head_length = 1 + varint::encode(payload.size(), head + 1);
+            sink.commit(head_length);
+            sink.write(payload.data(), payload.size());
+            const uint32_t checksum = to_big(map_log_format::checksum(kind, payload.data(), payload.size()));
+            sink.write(reinterpret_cast<const char*>(&checksum), checksum_length);
+            return head_length + payload.size() + checksum_length;
+        }
+    private:
+        static uint32_t __step (uint32_t hash, unsigned char x)
+        {
+            return (hash ^ x) * 16777619u;
+        }
+    };
+
+    /* Bytes of the last snapshot record of a log and of the change records
+     * after it. */
+    struct map_log_stats
+    {
+        size_t snapshot;
+        size_t changes;
+    };
+
+    /* Replays the log held in [data, data + length) into x and returns the
+     * length of its intact prefix. A bad header, or a record that passes its
+     * checksum but does not decode to exactly its payload, throws
+     * std::runtime_error. */
+    template <typename B = default_binder, typename M>
+    size_t replay_map_log (const char* data, size_t length, M& x, map_log_stats* stats = nullptr)
+    {
+        typedef typename mutable_value<typename M::value_type>::type entry_t;
+
+        if (length < map_log_format::header_length || std::memcmp(data, map_log_format::magic(), map_log_format::header_length) != 0)
+        {
+            throw std::runtime_error("Not a map log.");
+        }
+        B binder;
+        map_log_stats totals {0, 0};
+        x.clear();
+        const char* cursor = data + map_log_format::header_length;
+        const char* end = data + length;
+        while (cursor != end)
+        {
+            const char kind = *cursor;
+            uint64_t payload_length = 0;
+            const char* payload = nullptr;
+            try
+            {
+                payload = varint::decode(cursor + 1, end, payload_length);
+            }
+            catch (const std::exception&)
+            {
+                break;
+            }
+            if (static_cast<uint64_t>(end - payload) < payload_length + map_log_format::checksum_length)
+            {
+                break;
+            }
+            const char* checksum = payload + payload_length;
+            uint32_t stored;
+            std::memcpy(&stored, checksum, sizeof(stored));
+            if (to_big(stored) != map_log_format::checksum(kind, payload, static_cast<size_t>(payload_length)))
+            {
+                break;
+            }
+            if (kind != map_log_format::snapshot && kind != map_log_format::insert && kind != map_log_format::update && kind != map_log_format::erase)
+            {
+                throw std::runtime_error("Unknown map log record.");
+            }
+            span_source source (payload, static_cast<size_t>(payload_length));
+            try
+            {
+                switch (kind)
+                {
+                case map_log_format::snapshot:
+                    binder(x, source);
+                    break;
+                case map_log_format::insert:
+                case map_log_format::update:
+                    {
+                        entry_t entry;
+                        binder(entry.first, source);
+                        binder(entry.second, source);
+                        auto found = x.find(entry.first);
+                        if (found != x.end())
+                        {
+                            found->second = std::move(entry.second);
+                        }
+                        else
+                        {
+                            x.insert(std::move(entry));
+                        }
+                    }
+                    break;
+                case map_log_format::erase:
+                    {
+                        typename entry_t::first_type key {};
+                        binder(key, source);
+                        x.erase(key);
+                    }
+                    break;
+                }
+            }
+            catch (const std::exception&)
+            {
+                /* Binders report bad input as out_of_range, length_error,
+                 * runtime_error or, for a huge count, bad_alloc. */
+                throw std::runtime_error("Malformed map log record.");
+            }
+            if (source.available() != 0)
+            {
+                throw std::runtime_error("Malformed map log record.");
+            }
+            const char* next = checksum + map_log_format::checksum_length;
+            if (kind == map_log_format::snapshot)
+            {
+                totals.snapshot = static_cast<size_t>(next - cursor);
+                totals.changes = 0;
+            }
+            else
+            {
+                totals.changes += static_cast<size_t>(next - cursor);
+            }
+            cursor = next;
+        }
+        if (stats != nullptr)
+        {
+            *stats = totals;
+        }
+        return static_cast<size_t>(cursor - data);
+    }
+
+    /* An associative container kept on disk as a map log. Opening replays
+     * the file; every change then appends one record as long as its own
+     * encoding. Once the change records outgrow compaction_ratio times the
+     * last snapshot (and min_compaction_length) the log is rewritten as one
+     * snapshot, which keeps the file and the replay proportional to the
+     * container while a change costs O(its encoding) amortized; a ratio of
+     * 0 leaves compaction to the caller.
+     *
+     * Records are buffered: flush() hands them to the OS, sync() makes them
+     * durable. Failures throw std::system_error, after which the log should
+     * be reopened. */
+    template <typename M, typename B = default_binder>
+    class map_log
+    {
+    public:
+        typedef M map_type;
+        typedef typename M::key_type key_type;
+        typedef typename M::mapped_type mapped_type;
+
+        static const size_t min_compaction_length = 64 * 1024;
+
+        explicit map_log (const std::string& path, double compaction_ratio = 2.0) : m_path(path), m_ratio(compaction_ratio), m_fd(-1), m_base(0), m_snapshot(0), m_changes(0)
+        {
+            __open();
+        }
+
+        map_log (const map_log&) = delete;
+        map_log& operator= (const map_log&) = delete;
+
+        ~map_log()
+        {
+            try
+            {
+                close();
+            }
+            catch (const std::exception&) {}
+        }
+
+        const M& get () const
+        {
+            return m_map;
+        }
+
+        const M& operator* () const
+        {
+            return m_map;
+        }
+
+        const M* operator-> () const
+        {
+            return &m_map;
+        }
+
+        /* Inserts key or replaces its value. */
+        void assign (const key_type& key, const mapped_type& value)
+        {
+            __check();
+            m_scratch.clear();
+            {
+                string_sink sink (m_scratch);
+                m_binder(sink, key);
+                m_binder(sink, value);
+            }
+            auto found = m_map.find(key);
+            m_changes += map_log_format::write(*m_sink, found != m_map.end() ? map_log_format::update : map_log_format::insert, m_scratch);
+            if (found != m_map.end())
+            {
+                found->second = value;
+            }
+            else
+            {
+                m_map.insert(typename M::value_type(key, value));
+            }
+            __compact_if_due();
+        }
+
+        /* Returns whether key was there; nothing is logged if it was not. */
+        bool erase (const key_type& key)
+        {
+            __check();
+            auto found = m_map.find(key);
+            if (found == m_map.end())
+            {
+                return false;
+            }
+            m_scratch.clear();
+            {
+                string_sink sink (m_scratch);
+                m_binder(sink, key);
+            }
+            m_changes += map_log_format::write(*m_sink, map_log_format::erase, m_scratch);
+            m_map.erase(found);
+            __compact_if_due();
+            return true;
+        }
+
+        /* Rewrites the log as a snapshot of the container. The new log is
+         * synced and then renamed over the old one, so a crash leaves one
+         * of the two intact. */
+        void compact ()
+        {
+            __check();
+            m_sink->flush();
+            const std::string path = m_path + ".compact";
+            int fd = __open_file(path, true);
+            size_t snapshot = 0;
+            try
+            {
+                m_scratch.clear();
+                {
+                    string_sink sink (m_scratch);
+                    m_binder(sink, m_map);
+                }
+                {
+                    fd_sink sink (fd);
+                    sink.write(map_log_format::magic(), map_log_format::header_length);
+                    snapshot = map_log_format::write(sink, map_log_format::snapshot, m_scratch);
+                    sink.flush();
+                }
+                std::string().swap(m_scratch);
+                if (__sync(fd) != 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "fsync");
+                }
+            }
+            catch (...)
+            {
+                __close(fd);
+                std::remove(path.c_str());
+                throw;
+            }
+            if (__close(fd) != 0 || !__replace(path, m_path))
+            {
+                int error = errno;
+                std::remove(path.c_str());
+                throw std::system_error(error, std::generic_category(), "rename");
+            }
+            __sync_directory();
+            m_sink.reset();
+            __close(m_fd);
+            m_fd = -1;
+            m_fd = __open_file(m_path, false);
+            __seek(map_log_format::header_length + snapshot);
+            m_snapshot = snapshot;
+            m_changes = 0;
+        }
+
+        void flush ()
+        {
+            __check();
+            m_sink->flush();
+        }
+
+        void sync ()
+        {
+            flush();
+            if (__sync(m_fd) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "fsync");
+            }
+        }
+
+        void close ()
+        {
+            if (m_fd < 0)
+            {
+                return;
+            }
+            int fd = m_fd;
+            m_fd = -1;
+            try
+            {
+                m_sink->flush();
+            }
+            catch (...)
+            {
+                m_sink.reset();
+                __close(fd);
+                throw;
+            }
+            m_sink.reset();
+            if (__close(fd) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "close");
+            }
+        }
+
+        /* Bytes of the log, buffered records included. */
+        uint64_t length () const
+        {
+            return m_base + (m_sink ? m_sink->size() : 0);
+        }
+
+        map_log_stats stats () const
+        {
+            return map_log_stats {m_snapshot, m_changes};
+        }
+    private:
+        /* Replays what the file holds and cuts off a torn tail; a file cut
+         * inside its header starts over. */
+        void __open ()
+        {
+            m_fd = __open_file(m_path, false);
+            try
+            {
+                struct stat info;
+                if (::fstat(m_fd, &info) != 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "fstat");
+                }
+                const size_t size = static_cast<size_t>(info.st_size);
+                size_t valid = 0;
+                if (size >= map_log_format::header_length)
+                {
+                    mapped_file file (m_path);
+                    map_log_stats stats {0, 0};
+                    valid = replay_map_log<B>(file.data(), file.size(), m_map, &stats);
+                    m_snapshot = stats.snapshot;
+                    m_changes = stats.changes;
+                }
+                if (valid < size && __truncate(m_fd, valid) != 0)
+                {
+                    throw std::system_error(errno, std::generic_category(), "ftruncate");
+                }
+                __seek(valid);
+                if (valid == 0)
+                {
+                    m_sink->write(map_log_format::magic(), map_log_format::header_length);
+                }
+            }
+            catch (...)
+            {
+                m_sink.reset();
+                __close(m_fd);
+                m_fd = -1;
+                throw;
+            }
+        }
+
+        void __seek (uint64_t offset)
+        {
+#if defined(_WIN32)
+            const bool failed = ::_lseeki64(m_fd, static_cast<__int64>(offset), SEEK_SET) < 0;
+#else
+            const bool failed = ::lseek(m_fd, static_cast<off_t>(offset), SEEK_SET) < 0;
+#endif
+            if (failed)
+            {
+                throw std::system_error(errno, std::generic_category(), "lseek");
+            }
+            m_base = offset;
+            m_sink.reset(new fd_sink(m_fd));
+        }
+
+        /* Closed, or left without a sink by a failed compact(). */
+        void __check () const
+        {
+            if (m_fd < 0 || !m_sink)
+            {
+                throw std::system_error(EBADF, std::generic_category(), "write");
+            }
+        }
+
+        void __compact_if_due ()
+        {
+            if (m_ratio > 0 && static_cast<double>(m_changes) > std::max(static_cast<double>(min_compaction_length), m_ratio * static_cast<double>(m_snapshot)))
+            {
+                compact();
+            }
+        }
+
+        static int __open_file (const std::string& path, bool truncate)
+        {
+#if defined(_WIN32)
+            int fd = ::_open(path.c_str(), (truncate ? _O_WRONLY | _O_TRUNC : _O_RDWR) | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+            int fd = ::open(path.c_str(), (truncate ? O_WRONLY | O_TRUNC : O_RDWR) | O_CREAT, 0644);
+#endif
+            if (fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "open");
+            }
+            return fd;
+        }
+
+        static int __close (int fd)
+        {
+#if defined(_WIN32)
+            return ::_close(fd);
+#else
+            return ::close(fd);
+#endif
+        }
+
+        static int __sync (int fd)
+        {
+#if defined(_WIN32)
+            return ::_commit(fd);
+#elif defined(__linux__)
+            return ::fdatasync(fd);
+#else
+            return ::fsync(fd);
+#endif
+        }
+
+        static int __truncate (int fd, size_t length)
+        {
+#if defined(_WIN32)
+            return ::_chsize_s(fd, static_cast<__int64>(length)) == 0 ? 0 : -1;
+#else
+            return ::ftruncate(fd, static_cast<off_t>(length));
+#endif
+        }
+
+        static bool __replace (const std::string& from, const std::string& to)
+        {
+#if defined(_WIN32)
+            return ::MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+            return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+        }
+
+        /* Makes the rename durable; best effort. */
+        void __sync_directory () const
+        {
+#if !defined(_WIN32)
+            const size_t slash = m_path.rfind('/');
+            const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : m_path.substr(0, slash);
+            int fd = ::open(directory.c_str(), O_RDONLY);
+            if (fd >= 0)
+            {
+                ::fsync(fd);
+                ::close(fd);
+            }
+#endif
+        }
+
+        std::string m_path;
+        double m_ratio;
+        M m_map;
+        B m_binder;
+        int m_fd;
+        uint64_t m_base;
+        std::unique_ptr<fd_sink> m_sink;
+        std::string m_scratch;
+        size_t m_snapshot;
+        size_t m_changes;
+    };
+};
+
+#endif	/* MAP_LOG_HPP */
+
@@ -0,0 +1,173 @@
+/*
+ * File:   mapped_file.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 1:40 PM
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define	MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <system_error>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace data
+{
+    /* Read-only memory mapping of a whole file. Failures to open or map the
+     * file throw std::system_error. */
+    class mapped_file
+    {
+    public:
+        mapped_file() : m_data(nullptr), m_size(0) {}
+
+        explicit mapped_file (const std::string& path) : m_data(nullptr), m_size(0)
+        {
+            open(path);
+        }
+
+        mapped_file (mapped_file&& x) : m_data(x.m_data), m_size(x.m_size)
+        {
+            x.m_data = nullptr;
+            x.m_size = 0;
+        }
+
+        mapped_file& operator= (mapped_file&& x)
+        {
+            if (this != &x)
+            {
+                close();
+                m_data = x.m_data;
+                m_size = x.m_size;
+                x.m_data = nullptr;
+                x.m_size = 0;
+            }
+            return *this;
+        }
+
+        mapped_file (const mapped_file&) = delete;
+        mapped_file& operator= (const mapped_file&) = delete;
+
+        ~mapped_file()
+        {
+            close();
+        }
+
+        const char* data () const
+        {
+            return m_data;
+        }
+
+        size_t size () const
+        {
+            return m_size;
+        }
+
+#if defined(_WIN32)
+        void open (const std::string& path)
+        {
+            close();
+            HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+            {
+                throw std::system_error(static_cast<int>(::GetLastError()), std::system_category(), "CreateFile");
+            }
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(file, &size))
+            {
+                DWORD error = ::GetLastError();
+                ::CloseHandle(file);
+                throw std::system_error(static_cast<int>(error), std::system_category(), "GetFileSizeEx");
+            }
+            if (size.QuadPart == 0)
+            {
+                ::CloseHandle(file);
+                return;
+            }
+            HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            DWORD error = ::GetLastError();
+            ::CloseHandle(file);
+            if (mapping == nullptr)
+            {
+                throw std::system_error(static_cast<int>(error), std::system_category(), "CreateFileMapping");
+            }
+            void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            error = ::GetLastError();
+            ::CloseHandle(mapping);
+            if (view == nullptr)
+            {
+                throw std::system_error(static_cast<int>(error), std::system_category(), "MapViewOfFile");
+            }
+            m_data = static_cast<const char*>(view);
+            m_size = static_cast<size_t>(size.QuadPart);
+        }
+
+        void close ()
+        {
+            if (m_data != nullptr)
+            {
+                ::UnmapViewOfFile(m_data);
+            }
+            m_data = nullptr;
+            m_size = 0;
+        }
+#else
+        void open (const std::string& path)
+        {
+            close();
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "open");
+            }
+            struct stat info;
+            if (::fstat(fd, &info) != 0)
+            {
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "fstat");
+            }
+            if (info.st_size == 0)
+            {
+                ::close(fd);
+                return;
+            }
+            void* view = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            int error = errno;
+            ::close(fd);
+            if (view == MAP_FAILED)
+            {
+                throw std::system_error(error, std::generic_category(), "mmap");
+            }
+            m_data = static_cast<const char*>(view);
+            m_size = static_cast<size_t>(info.st_size);
+        }
+
+        void close ()
+        {
+            if (m_data != nullptr)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+            m_data = nullptr;
+            m_size = 0;
+        }
+#endif
+    private:
+        const char* m_data;
+        size_t m_size;
+    };
+};
+
+#endif	/* MAPPED_FILE_HPP */
+
@@ -0,0 +1,154 @@
+/*
+ * File:   native_binder.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 2:10 AM
+ */
+
+#ifndef NATIVE_BINDER_HPP
+#define	NATIVE_BINDER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./sink.hpp"
+
+/* Native-order wire mode. The default binders write every scalar
+ * big-endian, so a little-endian writer and reader both reverse each one
+ * for nothing. native_binder writes host order instead, after a header
+ * recording which order that is, and a reader reverses only when the
+ * header it read says the writer had the other one:
+ *
+ *   data::native_binder binder;
+ *   binder.write_header(sink);
+ *   binder(sink, snapshot);
+ *   ...
+ *   binder.read_header(source);
+ *   binder(snapshot, source);
+ *
+ * Apart from the header the format is that of default_binder on a
+ * big-endian host, so a stream written by one with "SOXB" in front reads
+ * back with native_binder anywhere. Lengths are varints in either mode;
+ * views (see view.hpp) take the order as their wire parameter. */
+
+namespace data
+{
+    struct native_header
+    {
+        static const size_t length = 4;
+
+        static void encode (char* data, bool is_big)
+        {
+            std::memcpy(data, "SOX", 3);
+            data[3] = is_big ? 'B' : 'L';
+        }
+
+        /* Whether data holds a header; is_big is set if it does. */
+        static bool decode (const char* data, bool& is_big)
+        {
+            if (std::memcmp(data, "SOX", 3) != 0 || (data[3] != 'B' && data[3] != 'L'))
+            {
+                return false;
+            }
+            is_big = data[3] == 'B';
+            return true;
+        }
+    };
+
+    /* default_binder over native_wire. Until a header is read, input is
+     * taken to be in host order. */
+    template <typename _Provider = mock>
+    class basic_native_binder : public composite_binder<_Provider, tuple_binder, indexed_binder, struct_binder<length_type, native_wire>,
+            sequence_binder<length_type, native_wire>, length_binder, basic_trivial_binder<native_wire>>
+    {
+        typedef composite_binder<_Provider, tuple_binder, indexed_binder, struct_binder<length_type, native_wire>,
+                sequence_binder<length_type, native_wire>, length_binder, basic_trivial_binder<native_wire>> base_t;
+    public:
+        basic_native_binder () : base_t(), m_reverse(false) {}
+
+        template <typename P, typename = typename std::enable_if<!std::is_same<typename std::decay<P>::type, basic_native_binder>::value>::type>
+        explicit basic_native_binder (P&& provider) : base_t(std::forward<P>(provider)), m_reverse(false) {}
+
+        template <typename S>
+        typename std::enable_if<is_output<S>::value, S&>::type write_header (S& stream) const
+        {
+            char header [native_header::length];
+            native_header::encode(header, byte_order::is_big);
+            stream.write(header, native_header::length);
+            return stream;
+        }
+
+        /* Anything but a header throws std::runtime_error. */
+        basic_source& read_header (basic_source& source)
+        {
+            bool is_big = false;
+            if (!native_header::decode(source.require(native_header::length), is_big))
+            {
+                throw std::runtime_error("Not a native-order stream.");
+            }
+            source.consume(native_header::length);
+            reverse_on_read(is_big != byte_order::is_big);
+            return source;
+        }
+
+        /* Anything but a header sets failbit. */
+        template <typename _Ttr>
+        std::basic_istream<char, _Ttr>& read_header (std::basic_istream<char, _Ttr>& stream)
+        {
+            char header [native_header::length];
+            bool is_big = false;
+            if (!stream.read(header, native_header::length) || !native_header::decode(header, is_big))
+            {
+                stream.setstate(std::ios_base::failbit);
+                return stream;
+            }
+            reverse_on_read(is_big != byte_order::is_big);
+            return stream;
+        }
+
+        /* Whether input is reversed, i.e. was written by a host of the
+         * other byte order. */
+        bool reverse_on_read () const
+        {
+            return m_reverse;
+        }
+
+        void reverse_on_read (bool x)
+        {
+            m_reverse = x;
+            __reverse_on_read<0>(x);
+        }
+    private:
+        template <size_t I>
+        typename std::enable_if<I < std::tuple_size<typename base_t::stored_t>::value>::type __reverse_on_read (bool x)
+        {
+            __set(std::get<I>(this->m_binders), x, 0);
+            __reverse_on_read<I + 1>(x);
+        }
+
+        template <size_t I>
+        typename std::enable_if<I == std::tuple_size<typename base_t::stored_t>::value>::type __reverse_on_read (bool) {}
+
+        template <typename B>
+        static auto __set (B& binder, bool x, int) -> decltype(binder.order().reverse_on_read(x), void())
+        {
+            binder.order().reverse_on_read(x);
+        }
+
+        template <typename B>
+        static void __set (B&, bool, long) {}
+
+        bool m_reverse;
+    };
+
+    typedef basic_native_binder<> native_binder;
+};
+
+#endif	/* NATIVE_BINDER_HPP */
+
@@ -0,0 +1,422 @@
+/*
+ * File:   packed_binder.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 8:20 PM
+ */
+
+#ifndef PACKED_BINDER_HPP
+#define	PACKED_BINDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./sink.hpp"
+#include "./varint.hpp"
+#include "./xor_float_binder.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace data
+{
+    /* Sequences of integers wider than a byte (vectors, deques, lists,
+     * sets...); strings and bytes are left to the bulk sequence path. */
+    template <typename T, bool = is_forward_sequence<T>::value>
+    struct is_packable_sequence
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T>
+    struct is_packable_sequence<T, true>
+    {
+        typedef typename std::decay<decltype(*std::begin(std::declval<T&>()))>::type element_t;
+
+        typedef std::integral_constant<bool, std::is_integral<element_t>::value && !std::is_same<element_t, bool>::value && (sizeof(element_t) > 1)> type;
+        static const bool value = type::value;
+    };
+
+    namespace __packed
+    {
+        /* Values per block; each block is bit-packed with its own width. */
+        static const size_t block_length = 128;
+        static const size_t lanes = 4;
+        /* Width marker of a block whose range needs more than 32 bits; its
+         * values follow as 64-bit little-endian words. */
+        static const uint8_t wide = 0xff;
+
+        /* Deltas wrap in the width of the element type U (unsigned), so a
+         * zigzagged delta of a 32-bit sequence always fits in 32 bits. */
+        template <typename U>
+        uint64_t zigzag (U x, U previous)
+        {
+            const U delta = static_cast<U>(x - previous);
+            return static_cast<U>(static_cast<U>(delta << 1) ^ static_cast<U>(0 - static_cast<U>(delta >> (8 * sizeof(U) - 1))));
+        }
+
+        template <typename U>
+        U unzigzag (uint64_t x, U previous)
+        {
+            const U z = static_cast<U>(x);
+            return static_cast<U>(previous + static_cast<U>(static_cast<U>(z >> 1) ^ static_cast<U>(0 - static_cast<U>(z & 1))));
+        }
+
+        inline unsigned width (uint32_t x)
+        {
+            return x == 0 ? 0 : 64 - varint::count_leading_zeros(x);
+        }
+
+        /* Vertical layout over 4 lanes: value i belongs to lane i % 4 and
+         * every lane is an LSB-first bit stream cut into 32-bit words, the
+         * words of the 4 lanes interleaved. A block of width b takes 16 * b
+         * bytes, and one SSE2 register moves a word of every lane at once. */
+        inline void pack (const uint32_t* in, unsigned b, uint32_t* out)
+        {
+#if defined(__SSE2__)
+            const __m128i* source = reinterpret_cast<const __m128i*>(in);
+            __m128i* target = reinterpret_cast<__m128i*>(out);
+            __m128i word = _mm_setzero_si128();
+            unsigned shift = 0;
+            for (size_t k = 0; k < block_length / lanes; ++k)
+            {
+                __m128i value = _mm_loadu_si128(source + k);
+                word = _mm_or_si128(word, _mm_sll_epi32(value, _mm_cvtsi32_si128(static_cast<int>(shift))));
+                shift += b;
+                if (shift >= 32)
+                {
+                    _mm_storeu_si128(target++, word);
+                    shift -= 32;
+                    word = shift > 0 ? _mm_srl_epi32(value, _mm_cvtsi32_si128(static_cast<int>(b - shift))) : _mm_setzero_si128();
+                }
+            }
+#else
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                uint64_t word = 0;
+                unsigned shift = 0;
+                uint32_t* target = out + lane;
+                for (size_t k = 0; k < block_length / lanes; ++k)
+                {
+                    word |= static_cast<uint64_t>(in[k * lanes + lane]) << shift;
+                    shift += b;
+                    if (shift >= 32)
+                    {
+                        *target = static_cast<uint32_t>(word);
+                        target += lanes;
+                        word >>= 32;
+                        shift -= 32;
+                    }
+                }
+            }
+#endif
+        }
+
+        inline void unpack (const uint32_t* in, unsigned b, uint32_t* out)
+        {
+            if (b == 0)
+            {
+                std::fill(out, out + block_length, 0);
+                return;
+            }
+#if defined(__SSE2__)
+            const __m128i* source = reinterpret_cast<const __m128i*>(in);
+            __m128i* target = reinterpret_cast<__m128i*>(out);
+            const __m128i mask = _mm_set1_epi32(b == 32 ? -1 : static_cast<int>((uint32_t(1) << b) - 1));
+            __m128i word = _mm_loadu_si128(source++);
+            unsigned shift = 0;
+            for (size_t k = 0; k < block_length / lanes; ++k)
+            {
+                __m128i value = _mm_srl_epi32(word, _mm_cvtsi32_si128(static_cast<int>(shift)));
+                shift += b;
+                if (shift > 32)
+                {
+                    word = _mm_loadu_si128(source++);
+                    shift -= 32;
+                    value = _mm_or_si128(value, _mm_sll_epi32(word, _mm_cvtsi32_si128(static_cast<int>(b - shift))));
+                }
+                else if (shift == 32 && k + 1 < block_length / lanes)
+                {
+                    word = _mm_loadu_si128(source++);
+                    shift = 0;
+                }
+                _mm_storeu_si128(target + k, _mm_and_si128(value, mask));
+            }
+#else
+            const uint64_t mask = (uint64_t(1) << b) - 1;
+            for (size_t lane = 0; lane < lanes; ++lane)
+            {
+                const uint32_t* source = in + lane;
+                uint64_t word = 0;
+                unsigned bits = 0;
+                for (size_t k = 0; k < block_length / lanes; ++k)
+                {
+                    if (bits < b)
+                    {
+                        word |= static_cast<uint64_t>(*source) << bits;
+                        source += lanes;
+                        bits += 32;
+                    }
+                    out[k * lanes + lane] = static_cast<uint32_t>(word & mask);
+                    word >>= b;
+                    bits -= b;
+                }
+            }
+#endif
+        }
+
+        /* Encodes one block of zigzagged deltas; the tail of a short block
+         * is padded with the minimum, hence deltas holds a full block. */
+        inline size_t encode_block (uint64_t* deltas, size_t length, char* out)
+        {
+            uint64_t low = deltas[0];
+            uint64_t high = deltas[0];
+            for (size_t i = 1; i < length; ++i)
+            {
+                low = std::min(low, deltas[i]);
+                high = std::max(high, deltas[i]);
+            }
+            std::fill(deltas + length, deltas + block_length, low);
+            char* cursor = out;
+            if (high - low > 0xffffffffu)
+            {
+                *cursor++ = static_cast<char>(wide);
+                cursor += varint::encode(low, cursor);
+                for (size_t i = 0; i < block_length; ++i)
+                {
+                    deltas[i] = to_little(deltas[i] - low);
+                }
+                std::memcpy(cursor, deltas, block_length * sizeof(uint64_t));
+                return static_cast<size_t>(cursor - out) + block_length * sizeof(uint64_t);
+            }
+            uint32_t values [block_length];
+            for (size_t i = 0; i < block_length; ++i)
+            {
+                values[i] = static_cast<uint32_t>(deltas[i] - low);
+            }
+            unsigned b = width(static_cast<uint32_t>(high - low));
+            *cursor++ = static_cast<char>(b);
+            cursor += varint::encode(low, cursor);
+            uint32_t words [block_length];
+            pack(values, b, words);
+            to_little(words, lanes * b);
+            std::memcpy(cursor, words, lanes * b * sizeof(uint32_t));
+            return static_cast<size_t>(cursor - out) + lanes * b * sizeof(uint32_t);
+        }
+
+        /* Largest encoded block: marker, varint minimum, wide payload. */
+        static const size_t max_block_size = 1 + varint::max_length + block_length * sizeof(uint64_t);
+
+        inline size_t payload_size (uint8_t b)
+        {
+            if (b == wide)
+            {
+                return block_length * sizeof(uint64_t);
+            }
+            if (b > 32)
+            {
+                throw std::runtime_error("Corrupted packed block.");
+            }
+            return lanes * b * sizeof(uint32_t);
+        }
+
+        inline void decode_payload (uint8_t b, uint64_t low, const char* data, uint64_t* deltas)
+        {
+            if (b == wide)
+            {
+                for (size_t i = 0; i < block_length; ++i, data += sizeof(uint64_t))
+                {
+                    uint64_t word;
+                    std::memcpy(&word, data, sizeof(word));
+                    deltas[i] = to_little(word) + low;
+                }
+                return;
+            }
+            uint32_t words [block_length];
+            uint32_t values [block_length];
+            std::memcpy(words, data, lanes * b * sizeof(uint32_t));
+            to_little(words, lanes * b);
+            unpack(words, b, values);
+            for (size_t i = 0; i < block_length; ++i)
+            {
+                deltas[i] = values[i] + low;
+            }
+        }
+    };
+
+    /* Integer sequences as blocks of 128 zigzagged deltas, each block
+     * bit-packed relative to its minimum (frame of reference):
+     *
+     *   element count, then per block: width byte, minimum (varint),
+     *   16 * width bytes in the 4-lane vertical layout (a width byte of
+     *   0xff is followed by 128 64-bit words instead)
+     *
+     * Sorted sets and monotonic timestamps pack into a few bits per
+     * element. Deltas wrap in the element width, so every value
+     * round-trips; random data costs a few header bytes per block.
+     * Opt in by listing it before sequence_binder, see packing_binder. */
+    struct packed_integer_binder
+    {
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_packable_sequence<T>::value && sizeof(typename S::char_type) == 1, S&>::type
+        operator() (S& stream, T&& x, Cb&& callback) const
+        {
+            typedef typename std::make_unsigned<typename is_packable_sequence<T>::element_t>::type unsigned_t;
+
+            length_type length {__count(x, 0)};
+            callback(stream, length);
+            uint64_t deltas [__packed::block_length];
+            char block [__packed::max_block_size];
+            unsigned_t previous = 0;
+            auto iter = std::begin(x);
+            for (size_t left = length.value, step; left > 0; left -= step)
+            {
+                step = std::min(left, __packed::block_length);
+                for (size_t i = 0; i < step; ++i, ++iter)
+                {
+                    const unsigned_t value = static_cast<unsigned_t>(*iter);
+                    deltas[i] = __packed::zigzag(value, previous);
+                    previous = value;
+                }
+                stream.write(block, __packed::encode_block(deltas, step, block));
+            }
+            return stream;
+        }
+
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_packable_sequence<T>::value && sizeof(typename S::char_type) == 1, T&>::type
+        operator() (T& x, S& stream, Cb&& callback) const
+        {
+            typedef typename std::decay<T>::type type_t;
+            typedef typename is_packable_sequence<T>::element_t element_t;
+            typedef typename std::make_unsigned<element_t>::type unsigned_t;
+
+            length_type length {};
+            callback(length, stream);
+            type_t& target = const_cast<type_t&>(x);
+            target.clear();
+            /* The count is untrusted until its blocks have been read. */
+            __reserve(target, std::min(length.value, __packed::block_length), 0);
+            uint64_t deltas [__packed::block_length];
+            element_t values [__packed::block_length];
+            char payload [__packed::block_length * sizeof(uint64_t)];
+            unsigned_t previous = 0;
+            for (size_t left = length.value, step; left > 0 && __good(stream); left -= step)
+            {
+                uint8_t b = static_cast<uint8_t>(__get(stream));
+                length_type low {};
+                callback(low, stream);
+                if (!__read(stream, payload, __packed::payload_size(b)))
+                {
+                    break;
+                }
+                __packed::decode_payload(b, low.value, payload, deltas);
+                step = std::min(left, __packed::block_length);
+                for (size_t i = 0; i < step; ++i)
+                {
+                    previous = __packed::unzigzag(deltas[i], previous);
+                    values[i] = static_cast<element_t>(previous);
+                }
+                __append(target, values, values + step, 0);
+            }
+            return x;
+        }
+    private:
+        template <typename C>
+        static auto __count (const C& x, int) -> decltype(static_cast<size_t>(x.size()))
+        {
+            return static_cast<size_t>(x.size());
+        }
+
+        template <typename C>
+        static size_t __count (const C& x, long)
+        {
+            return static_cast<size_t>(std::distance(std::begin(x), std::end(x)));
+        }
+
+        template <typename C>
+        static auto __reserve (C& target, size_t length, int) -> decltype(target.reserve(length), void())
+        {
+            target.reserve(length);
+        }
+
+        template <typename C>
+        static void __reserve (C&, size_t, long) {}
+
+        template <typename C, typename I>
+        static auto __append (C& target, I first, I last, int) -> decltype(target.insert(target.end(), first, last), void())
+        {
+            target.insert(target.end(), first, last);
+        }
+
+        /* Sets: the values come in order, so the end hint is O(1) each. */
+        template <typename C, typename I>
+        static void __append (C& target, I first, I last, long)
+        {
+            for (; first != last; ++first)
+            {
+                target.insert(target.end(), *first);
+            }
+        }
+
+        template <typename _Ttr>
+        static char __get (std::basic_istream<char, _Ttr>& stream)
+        {
+            return static_cast<char>(stream.get());
+        }
+
+        static char __get (basic_source& source)
+        {
+            return source.get();
+        }
+
+        template <typename _Ttr>
+        static bool __read (std::basic_istream<char, _Ttr>& stream, char* data, size_t n)
+        {
+            return static_cast<bool>(stream.read(data, static_cast<std::streamsize>(n)));
+        }
+
+        static bool __read (basic_source& source, char* data, size_t n)
+        {
+            source.read(data, n);
+            return true;
+        }
+
+        template <typename _Ttr>
+        static bool __good (const std::basic_istream<char, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+    };
+
+    template <>
+    struct binder_name<packed_integer_binder>
+    {
+        static const char* value ()
+        {
+            return "packed";
+        }
+    };
+
+    /* default_binder with packed integer and XOR-coded float sequences. */
+    typedef composite_binder<mock, tuple_binder, indexed_binder, struct_binder<length_type>, packed_integer_binder, xor_float_binder, sequence_binder<length_type>, length_binder, trivial_binder> packing_binder;
+};
+
+#endif	/* PACKED_BINDER_HPP */
+
@@ -0,0 +1,193 @@
+/*
+ * File:   sequence_reader.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 6:05 PM
+ */
+
+#ifndef SEQUENCE_READER_HPP
+#define	SEQUENCE_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <istream>
+#include <type_traits>
+#include "./basic_binder.hpp"
+#include "./sink.hpp"
+
+namespace data
+{
+    /* Pulls the elements of a serialized container T out of an input one at
+     * a time. Only the current element is held in memory and its storage is
+     * reused for the next one, so a dump of any size is folded in constant
+     * space. The length prefix (and the offset table of an indexed<C>) is
+     * consumed on construction.
+     *
+     * On a std::istream iteration stops early once the stream fails, leaving
+     * the state for the caller to inspect; a basic_source throws instead. */
+    template <typename T, typename S = basic_source, typename B = default_binder>
+    class sequence_reader
+    {
+    public:
+        typedef typename mutable_value<typename T::value_type>::type value_type;
+
+        class iterator
+        {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef typename sequence_reader::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef const value_type& reference;
+
+            iterator() : m_reader(nullptr) {}
+            explicit iterator (sequence_reader* reader) : m_reader(reader) {}
+
+            reference operator* () const
+            {
+                return m_reader->m_value;
+            }
+
+            pointer operator-> () const
+            {
+                return &m_reader->m_value;
+            }
+
+            iterator& operator++ ()
+            {
+                if (!m_reader->__next())
+                {
+                    m_reader = nullptr;
+                }
+                return *this;
+            }
+
+            void operator++ (int)
+            {
+                ++*this;
+            }
+
+            bool operator== (const iterator& x) const
+            {
+                return m_reader == x.m_reader;
+            }
+
+            bool operator!= (const iterator& x) const
+            {
+                return m_reader != x.m_reader;
+            }
+        private:
+            sequence_reader* m_reader;
+        };
+
+        explicit sequence_reader (S& stream) : m_stream(stream), m_binder(), m_value(), m_size(0), m_left(0), m_current(false)
+        {
+            __header(typename is_indexed<T>::type());
+            length_type length {};
+            m_binder(length, m_stream);
+            if (__good(m_stream))
+            {
+                m_size = length.value;
+                m_left = length.value;
+            }
+        }
+
+        /* Number of elements declared by the length prefix. */
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        /* Number of elements not decoded yet. */
+        size_t remaining () const
+        {
+            return m_left;
+        }
+
+        iterator begin ()
+        {
+            if (!m_current && !__next())
+            {
+                return end();
+            }
+            return iterator(this);
+        }
+
+        iterator end ()
+        {
+            return iterator();
+        }
+
+        /* Moves the next element into x; returns false past the last one. */
+        bool next (value_type& x)
+        {
+            if (!m_current && !__next())
+            {
+                return false;
+            }
+            x = std::move(m_value);
+            m_current = false;
+            return true;
+        }
+    private:
+        void __header (std::true_type)
+        {
+            length_type block {};
+            length_type entries {};
+            m_binder(block, m_stream);
+            m_binder(entries, m_stream);
+            for (uint64_t offset; entries.value > 0 && __good(m_stream); --entries.value)
+            {
+                m_binder(offset, m_stream);
+            }
+        }
+
+        void __header (std::false_type) {}
+
+        bool __next ()
+        {
+            m_current = false;
+            if (m_left == 0)
+            {
+                return false;
+            }
+            m_binder(m_value, m_stream);
+            if (!__good(m_stream))
+            {
+                m_left = 0;
+                return false;
+            }
+            --m_left;
+            m_current = true;
+            return true;
+        }
+
+        template <typename _Tch, typename _Ttr>
+        static bool __good (const std::basic_istream<_Tch, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+
+        S& m_stream;
+        B m_binder;
+        value_type m_value;
+        size_t m_size;
+        size_t m_left;
+        bool m_current;
+    };
+
+    template <typename T, typename S>
+    sequence_reader<T, S> read_sequence (S& stream)
+    {
+        return sequence_reader<T, S>(stream);
+    }
+};
+
+#endif	/* SEQUENCE_READER_HPP */
+
@@ -9,6 +9,11 @@
 #define	SERIALIZATION_HPP
 
 #include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "./byte_order.hpp"
 
 namespace data
 {
@@ -37,26 +42,9 @@ namespace data
 
     struct Endian
     {
-        typedef uint64_t probe_t;
-
-        static size_t endian_length()
-        {
-            volatile probe_t probe (1);
-            volatile uint8_t* volatile ptr_base = reinterpret_cast<volatile uint8_t*>(&probe);
-            volatile uint8_t* volatile ptr = ptr_base;
-            while (*ptr != 1)
-            {
-                ++ptr;
-            }
-            return (ptr - ptr_base) + 1;
-        }
-
-        static size_t length;
-        static bool is_big;
+        static constexpr bool is_big = byte_order::is_big;
+        static constexpr size_t length = is_big ? sizeof(uint64_t) : 1;
     };
-
-    size_t Endian::length = endian_length();
-    bool Endian::is_big = (length == 1);
     
     template <typename T, typename U>
     struct SerializableSequence : public basic_sequence<T, U>
@@ -90,12 +78,82 @@ namespace data
             }
             return *this;
         }
+
+        static constexpr bool native_order()
+        {
+            return basic_sequence<T, U>::length == 1 || Endian::is_big;
+        }
+
+        static type_t* serialize(type_t* first, size_t count)
+        {
+            return to_big(first, count);
+        }
+
+        static type_t* to_big(type_t* first, size_t count)
+        {
+            if (!Endian::is_big)
+            {
+                __swap_order(first, count);
+            }
+            return first;
+        }
+
+        static type_t* to_little(type_t* first, size_t count)
+        {
+            if (Endian::is_big)
+            {
+                __swap_order(first, count);
+            }
+            return first;
+        }
+
+        /* Unconditional reversal, between any two orders. */
+        SerializableSequence& reverse()
+        {
+            __swap_order();
+            return *this;
+        }
+
+        static type_t* reverse(type_t* first, size_t count)
+        {
+            __swap_order(first, count);
+            return first;
+        }
     private:
         void __swap_order()
         {
-            for (basic_t* begin = basic_sequence<T, U>::sequence, *end = basic_sequence<T, U>::sequence + basic_sequence<T, U>::length - 1; begin < end; ++begin, --end)
+            __swap_order(&this->value, 1);
+        }
+
+        static void __swap_order(type_t* first, size_t count)
+        {
+            __swap_order(first, count, std::integral_constant<bool, sizeof(basic_t) == 1>());
+        }
+
+        static void __swap_order(type_t* first, size_t count, std::true_type)
+        {
+            if (count == 1)
+            {
+                type_t value;
+                std::memcpy(&value, first, sizeof(type_t));
+                value = byte_swap(value);
+                std::memcpy(first, &value, sizeof(type_t));
+            }
+            else
+            {
+                byte_swap(first, count);
+            }
+        }
+
+        static void __swap_order(type_t* first, size_t count, std::false_type)
+        {
+            basic_t* ptr = reinterpret_cast<basic_t*>(first);
+            for (basic_t* last = ptr + count * basic_sequence<T, U>::length; ptr != last; ptr += basic_sequence<T, U>::length)
             {
-                std::swap(*begin, *end);
+                for (basic_t* begin = ptr, *end = ptr + basic_sequence<T, U>::length - 1; begin < end; ++begin, --end)
+                {
+                    std::swap(*begin, *end);
+                }
             }
         }
     };
@@ -0,0 +1,274 @@
+/*
+ * File:   serialized_size.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 3:30 PM
+ */
+
+#ifndef SERIALIZED_SIZE_HPP
+#define	SERIALIZED_SIZE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "./basic_binder.hpp"
+
+/* Sizes follow the layout written by default_binder (tuple_binder,
+ * indexed_binder, struct_binder<length_type>, sequence_binder<length_type>,
+ * length_binder, trivial_binder). */
+
+namespace data
+{
+    template <typename T, bool = is_reflected<T>::value>
+    struct fixed_struct_size
+    {
+        typedef std::integral_constant<size_t, 0> type;
+        static const size_t value = type::value;
+    };
+
+    /* Encoded size of every value of type T, or 0 if it depends on the
+     * value. */
+    template <typename T>
+    struct fixed_serialized_size
+    {
+        typedef std::integral_constant<size_t, std::is_scalar<T>::value ? sizeof(T) : fixed_struct_size<T>::value> type;
+        static const size_t value = type::value;
+    };
+
+    template <typename T>
+    struct fixed_serialized_size<const T> : public fixed_serialized_size<T> {};
+
+    template <>
+    struct fixed_serialized_size<std::tuple<>>
+    {
+        typedef std::integral_constant<size_t, 0> type;
+        static const size_t value = type::value;
+    };
+
+    template <typename T, typename... A>
+    struct fixed_serialized_size<std::tuple<T, A...>>
+    {
+        static const size_t head = fixed_serialized_size<T>::value;
+        static const size_t tail = sizeof...(A) == 0 ? 0 : fixed_serialized_size<std::tuple<A...>>::value;
+
+        typedef std::integral_constant<size_t, (head > 0 && (sizeof...(A) == 0 || tail > 0)) ? head + tail : 0> type;
+        static const size_t value = type::value;
+    };
+
+    template <typename T1, typename T2>
+    struct fixed_serialized_size<std::pair<T1, T2>> : public fixed_serialized_size<std::tuple<T1, T2>> {};
+
+    template <typename T>
+    struct fixed_struct_size<T, true> : public fixed_serialized_size<typename reflected_tuple<T>::type> {};
+
+    namespace __size
+    {
+        struct fixed_tag {};
+        struct length_tag {};
+        struct sequence_tag {};
+        struct indexed_tag {};
+        struct tuple_tag {};
+        struct pair_tag {};
+        struct struct_tag {};
+
+        template <typename T>
+        struct tag_of
+        {
+            typedef typename std::conditional<(fixed_serialized_size<T>::value > 0), fixed_tag,
+                    typename std::conditional<std::is_same<T, length_type>::value, length_tag,
+                    typename std::conditional<is_indexed<T>::value, indexed_tag,
+                    typename std::conditional<is_reflected<T>::value, struct_tag, sequence_tag>::type>::type>::type>::type type;
+        };
+
+        template <typename... A>
+        struct tag_of<std::tuple<A...>>
+        {
+            typedef typename std::conditional<(fixed_serialized_size<std::tuple<A...>>::value > 0), fixed_tag, tuple_tag>::type type;
+        };
+
+        template <typename T1, typename T2>
+        struct tag_of<std::pair<T1, T2>>
+        {
+            typedef typename std::conditional<(fixed_serialized_size<std::pair<T1, T2>>::value > 0), fixed_tag, pair_tag>::type type;
+        };
+
+        template <typename T, typename _Tag = typename tag_of<typename std::remove_cv<T>::type>::type>
+        struct traits;
+
+        template <typename T>
+        struct traits<T, fixed_tag>
+        {
+            static size_t size (const T&)
+            {
+                return fixed_serialized_size<T>::value;
+            }
+        };
+
+        template <typename T>
+        struct traits<T, length_tag>
+        {
+            static size_t size (const length_type& x)
+            {
+                return length_binder::encoded_length(x.value);
+            }
+        };
+
+        template <typename T>
+        struct traits<T, sequence_tag>
+        {
+            typedef typename std::decay<decltype(*std::begin(std::declval<T&>()))>::type element_t;
+
+            static size_t size (const T& x)
+            {
+                return __size(x, std::integral_constant<bool, (fixed_serialized_size<element_t>::value > 0)>());
+            }
+        private:
+            static size_t __size (const T& x, std::true_type)
+            {
+                size_t length = __count(x, 0);
+                return length_binder::encoded_length(length) + length * fixed_serialized_size<element_t>::value;
+            }
+
+            static size_t __size (const T& x, std::false_type)
+            {
+                size_t length = 0;
+                size_t result = 0;
+                for (auto iter = std::begin(x); iter != std::end(x); ++iter, ++length)
+                {
+                    result += traits<element_t>::size(*iter);
+                }
+                return length_binder::encoded_length(length) + result;
+            }
+
+            template <typename C>
+            static auto __count (const C& x, int) -> decltype(static_cast<size_t>(x.size()))
+            {
+                return static_cast<size_t>(x.size());
+            }
+
+            template <typename C>
+            static size_t __count (const C& x, long)
+            {
+                size_t length = 0;
+                for (auto iter = std::begin(x); iter != std::end(x); ++iter, ++length);
+                return length;
+            }
+        };
+
+        template <typename T>
+        struct traits<T, indexed_tag>
+        {
+            static size_t size (const T& x)
+            {
+                size_t length = traits<typename T::container_type>::size(x);
+                size_t entries = static_cast<size_t>(std::distance(std::begin(x), std::end(x)));
+                entries = (entries + T::block_length - 1) / T::block_length;
+                return length_binder::encoded_length(T::block_length) + length_binder::encoded_length(entries)
+                        + entries * sizeof(uint64_t) + length;
+            }
+        };
+
+        template <typename... A>
+        struct traits<std::tuple<A...>, tuple_tag>
+        {
+            static size_t size (const std::tuple<A...>& x)
+            {
+                return __size<0>(x);
+            }
+        private:
+            template <size_t I>
+            static typename std::enable_if<I < sizeof...(A), size_t>::type __size (const std::tuple<A...>& x)
+            {
+                return traits<typename std::tuple_element<I, std::tuple<A...>>::type>::size(std::get<I>(x)) + __size<I + 1>(x);
+            }
+
+            template <size_t I>
+            static typename std::enable_if<I == sizeof...(A), size_t>::type __size (const std::tuple<A...>&)
+            {
+                return 0;
+            }
+        };
+
+        template <typename T1, typename T2>
+        struct traits<std::pair<T1, T2>, pair_tag>
+        {
+            static size_t size (const std::pair<T1, T2>& x)
+            {
+                return traits<T1>::size(x.first) + traits<T2>::size(x.second);
+            }
+        };
+
+        template <typename T>
+        struct traits<T, struct_tag>
+        {
+            typedef typename fields<T>::type fields_t;
+
+            static size_t size (const T& x)
+            {
+                return __size<0>(x);
+            }
+        private:
+            template <size_t I>
+            static typename std::enable_if<I < std::tuple_size<fields_t>::value, size_t>::type __size (const T& x)
+            {
+                typedef typename std::tuple_element<I, fields_t>::type field_t;
+
+                return traits<typename field_t::type>::size(field_t::get(x)) + __size<I + 1>(x);
+            }
+
+            template <size_t I>
+            static typename std::enable_if<I == std::tuple_size<fields_t>::value, size_t>::type __size (const T&)
+            {
+                return 0;
+            }
+        };
+    };
+
+    template <typename T>
+    constexpr typename std::enable_if<(fixed_serialized_size<T>::value > 0), size_t>::type serialized_size (const T&)
+    {
+        return fixed_serialized_size<T>::value;
+    }
+
+    /* Exact number of bytes default_binder writes for x. */
+    template <typename T>
+    typename std::enable_if<fixed_serialized_size<T>::value == 0, size_t>::type serialized_size (const T& x)
+    {
+        return __size::traits<T>::size(x);
+    }
+
+    /* Encodes x into a string allocated once for its exact size. */
+    template <typename B, typename T>
+    std::string encode (B& binder, const T& x)
+    {
+        std::string result;
+        {
+            string_sink sink (result, serialized_size(x));
+            binder(sink, x);
+        }
+        return result;
+    }
+
+    template <typename T>
+    std::string encode (const T& x)
+    {
+        default_binder binder;
+        return encode(binder, x);
+    }
+
+    /* Encodes x into caller-provided storage and returns the number of bytes
+     * written; std::length_error is thrown if the storage is too small. */
+    template <typename B, typename T>
+    size_t encode (B& binder, const T& x, char* data, size_t length)
+    {
+        span_sink sink (data, length);
+        binder(sink, x);
+        return sink.size();
+    }
+};
+
+#endif	/* SERIALIZED_SIZE_HPP */
+
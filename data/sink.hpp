@@ -0,0 +1,574 @@
+/*
+ * File:   sink.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 11:05 AM
+ */
+
+#ifndef SINK_HPP
+#define	SINK_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <algorithm>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace data
+{
+    /* Contiguous output window [m_begin, m_end) with a write cursor. Writing
+     * is a bounds check and a memcpy; derived sinks only get involved when
+     * the window is exhausted (overflow) or the caller flushes (sync). */
+    class basic_sink
+    {
+    public:
+        typedef char char_type;
+
+        basic_sink() : m_begin(nullptr), m_cursor(nullptr), m_end(nullptr), m_offset(0) {}
+        virtual ~basic_sink() {}
+
+        basic_sink(const basic_sink&) = delete;
+        basic_sink& operator= (const basic_sink&) = delete;
+
+        /* Returns a pointer to at least n writable bytes; they become part of
+         * the output once committed. */
+        char_type* reserve (size_t n)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) < n)
+            {
+                overflow(n);
+            }
+            return m_cursor;
+        }
+
+        void commit (size_t n)
+        {
+            m_cursor += n;
+        }
+
+        basic_sink& write (const char_type* data, size_t n)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) >= n)
+            {
+                std::memcpy(m_cursor, data, n);
+                m_cursor += n;
+            }
+            else
+            {
+                xsputn(data, n);
+            }
+            return *this;
+        }
+
+        basic_sink& put (char_type x)
+        {
+            if (m_cursor == m_end)
+            {
+                overflow(1);
+            }
+            *m_cursor++ = x;
+            return *this;
+        }
+
+        basic_sink& flush ()
+        {
+            sync();
+            return *this;
+        }
+
+        /* Total number of bytes written through this sink. */
+        size_t size () const
+        {
+            return m_offset + static_cast<size_t>(m_cursor - m_begin);
+        }
+    protected:
+        /* Makes room for at least n contiguous bytes past the cursor. */
+        virtual void overflow (size_t n) = 0;
+
+        virtual void sync () {}
+
+        virtual void xsputn (const char_type* data, size_t n)
+        {
+            std::memcpy(reserve(n), data, n);
+            m_cursor += n;
+        }
+
+        void setp (char_type* begin, char_type* cursor, char_type* end)
+        {
+            m_begin = begin;
+            m_cursor = cursor;
+            m_end = end;
+        }
+
+        char_type* m_begin;
+        char_type* m_cursor;
+        char_type* m_end;
+        size_t m_offset;
+    };
+
+    /* Contiguous input window [m_cursor, m_end). Running past the end of the
+     * input throws std::out_of_range. */
+    class basic_source
+    {
+    public:
+        typedef char char_type;
+
+        basic_source() : m_begin(nullptr), m_cursor(nullptr), m_end(nullptr), m_offset(0) {}
+        virtual ~basic_source() {}
+
+        basic_source(const basic_source&) = delete;
+        basic_source& operator= (const basic_source&) = delete;
+
+        /* Returns a pointer to at least n readable bytes; they are released
+         * by consume. */
+        const char_type* require (size_t n)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) < n && !underflow(n))
+            {
+                throw std::out_of_range("Unexpected end of input.");
+            }
+            return m_cursor;
+        }
+
+        void consume (size_t n)
+        {
+            m_cursor += n;
+        }
+
+        basic_source& read (char_type* data, size_t n)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) >= n)
+            {
+                std::memcpy(data, m_cursor, n);
+                m_cursor += n;
+            }
+            else
+            {
+                xsgetn(data, n);
+            }
+            return *this;
+        }
+
+        char_type get ()
+        {
+            if (m_cursor == m_end && !underflow(1))
+            {
+                throw std::out_of_range("Unexpected end of input.");
+            }
+            return *m_cursor++;
+        }
+
+        bool eof ()
+        {
+            return m_cursor == m_end && !underflow(1);
+        }
+
+        /* Number of bytes consumed so far. */
+        size_t position () const
+        {
+            return m_offset + static_cast<size_t>(m_cursor - m_begin);
+        }
+
+        size_t available () const
+        {
+            return static_cast<size_t>(m_end - m_cursor);
+        }
+
+        /* Tries to make n bytes available without failing at the end of the
+         * input; returns the number that actually are. */
+        size_t fetch (size_t n)
+        {
+            if (static_cast<size_t>(m_end - m_cursor) < n)
+            {
+                underflow(n);
+            }
+            return static_cast<size_t>(m_end - m_cursor);
+        }
+    protected:
+        /* Makes at least n contiguous bytes available past the cursor;
+         * returns false if the input ends before that. */
+        virtual bool underflow (size_t n) = 0;
+
+        virtual void xsgetn (char_type* data, size_t n)
+        {
+            std::memcpy(data, require(n), n);
+            m_cursor += n;
+        }
+
+        void setg (const char_type* begin, const char_type* cursor, const char_type* end)
+        {
+            m_begin = begin;
+            m_cursor = cursor;
+            m_end = end;
+        }
+
+        const char_type* m_begin;
+        const char_type* m_cursor;
+        const char_type* m_end;
+        size_t m_offset;
+    };
+
+    template <typename S>
+    struct is_output
+    {
+        template <typename _Tch, typename _Ttr>
+        static std::true_type __test (const std::basic_ostream<_Tch, _Ttr>*);
+
+        static std::true_type __test (const basic_sink*);
+
+        static std::false_type __test (...);
+
+        typedef decltype(__test(std::declval<typename std::decay<S>::type*>())) type;
+        static const bool value = type::value;
+    };
+
+    template <typename S>
+    struct is_input
+    {
+        template <typename _Tch, typename _Ttr>
+        static std::true_type __test (const std::basic_istream<_Tch, _Ttr>*);
+
+        static std::true_type __test (const basic_source*);
+
+        static std::false_type __test (...);
+
+        typedef decltype(__test(std::declval<typename std::decay<S>::type*>())) type;
+        static const bool value = type::value;
+    };
+
+    /* Appends to a std::string, growing it geometrically. The string holds
+     * slack past the written bytes until the sink is flushed or destroyed. */
+    class string_sink : public basic_sink
+    {
+    public:
+        explicit string_sink (std::string& target) : m_target(target), m_base(target.size())
+        {
+            __bind(m_base);
+        }
+
+        /* Sizes the string for the expected output up front, so that an exact
+         * estimate costs a single allocation. */
+        string_sink (std::string& target, size_t expected) : m_target(target), m_base(target.size())
+        {
+            m_target.resize(m_base + expected);
+            __bind(m_base);
+        }
+
+        ~string_sink()
+        {
+            __truncate();
+        }
+    protected:
+        void overflow (size_t n)
+        {
+            size_t used = static_cast<size_t>(m_cursor - m_begin);
+            m_target.resize(m_base + std::max(used + n, 2 * used + 64));
+            __bind(m_base + used);
+        }
+
+        void sync ()
+        {
+            __truncate();
+        }
+    private:
+        void __bind (size_t used)
+        {
+            char_type* begin = m_target.empty() ? nullptr : &m_target[0];
+            setp(begin + m_base, begin + used, begin + m_target.size());
+        }
+
+        void __truncate ()
+        {
+            size_t used = static_cast<size_t>(m_cursor - m_begin);
+            m_target.resize(m_base + used);
+            __bind(m_base + used);
+        }
+
+        std::string& m_target;
+        size_t m_base;
+    };
+
+    /* Writes into caller-provided storage; running out of it throws
+     * std::length_error. */
+    class span_sink : public basic_sink
+    {
+    public:
+        span_sink (char_type* data, size_t length)
+        {
+            setp(data, data, data + length);
+        }
+    protected:
+        void overflow (size_t)
+        {
+            throw std::length_error("Sink capacity exceeded.");
+        }
+    };
+
+    /* Fixed-size staging buffer drained to a downstream target. Writes that
+     * do not fit into the buffer bypass it. */
+    class buffered_sink : public basic_sink
+    {
+    public:
+        static const size_t default_capacity = 64 * 1024;
+
+        explicit buffered_sink (size_t capacity = default_capacity) : m_buffer(capacity)
+        {
+            setp(&m_buffer[0], &m_buffer[0], &m_buffer[0] + m_buffer.size());
+        }
+    protected:
+        /* Hands n bytes over to the target. */
+        virtual void drain (const char_type* data, size_t n) = 0;
+
+        void overflow (size_t n)
+        {
+            __drain();
+            if (n > m_buffer.size())
+            {
+                m_buffer.resize(n);
+                setp(&m_buffer[0], &m_buffer[0], &m_buffer[0] + m_buffer.size());
+            }
+        }
+
+        void sync ()
+        {
+            __drain();
+        }
+
+        void xsputn (const char_type* data, size_t n)
+        {
+            if (n < m_buffer.size())
+            {
+                basic_sink::xsputn(data, n);
+                return;
+            }
+            __drain();
+            drain(data, n);
+            m_offset += n;
+        }
+
+        void __drain ()
+        {
+            size_t used = static_cast<size_t>(m_cursor - m_begin);
+            if (used > 0)
+            {
+                m_cursor = m_begin;
+                m_offset += used;
+                drain(m_begin, used);
+            }
+        }
+
+        std::vector<char_type> m_buffer;
+    };
+
+    template <typename _Ttr = std::char_traits<char>>
+    class basic_ostream_sink : public buffered_sink
+    {
+    public:
+        typedef std::basic_ostream<char, _Ttr> stream_t;
+
+        explicit basic_ostream_sink (stream_t& stream, size_t capacity = default_capacity) : buffered_sink(capacity), m_stream(stream) {}
+
+        ~basic_ostream_sink()
+        {
+            __drain();
+        }
+    protected:
+        void drain (const char_type* data, size_t n)
+        {
+            m_stream.write(data, static_cast<std::streamsize>(n));
+        }
+
+        void sync ()
+        {
+            __drain();
+            m_stream.flush();
+        }
+    private:
+        stream_t& m_stream;
+    };
+
+    typedef basic_ostream_sink<> ostream_sink;
+
+    /* Writes to a POSIX file descriptor; failures throw std::system_error.
+     * The descriptor is not owned. */
+    class fd_sink : public buffered_sink
+    {
+    public:
+        explicit fd_sink (int fd, size_t capacity = default_capacity) : buffered_sink(capacity), m_fd(fd) {}
+
+        ~fd_sink()
+        {
+            try
+            {
+                __drain();
+            }
+            catch (const std::system_error&) {}
+        }
+    protected:
+        void drain (const char_type* data, size_t n)
+        {
+            while (n > 0)
+            {
+                auto written = ::write(m_fd, data, n);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    throw std::system_error(errno, std::generic_category(), "write");
+                }
+                data += written;
+                n -= static_cast<size_t>(written);
+            }
+        }
+    private:
+        int m_fd;
+    };
+
+    /* Reads from caller-provided memory. */
+    class span_source : public basic_source
+    {
+    public:
+        span_source (const char_type* data, size_t length)
+        {
+            setg(data, data, data + length);
+        }
+
+        explicit span_source (const std::string& data)
+        {
+            setg(data.data(), data.data(), data.data() + data.size());
+        }
+    protected:
+        bool underflow (size_t)
+        {
+            return false;
+        }
+    };
+
+    typedef span_source string_source;
+
+    /* Refills a staging buffer from an upstream origin, keeping unconsumed
+     * bytes so that require(n) always sees them contiguously. */
+    class buffered_source : public basic_source
+    {
+    public:
+        static const size_t default_capacity = 64 * 1024;
+
+        explicit buffered_source (size_t capacity = default_capacity) : m_buffer(capacity)
+        {
+            setg(&m_buffer[0], &m_buffer[0], &m_buffer[0]);
+        }
+    protected:
+        /* Reads up to n bytes into data; returns 0 at the end of input. */
+        virtual size_t fill (char_type* data, size_t n) = 0;
+
+        bool underflow (size_t n)
+        {
+            size_t left = static_cast<size_t>(m_end - m_cursor);
+            m_offset += static_cast<size_t>(m_cursor - m_begin);
+            std::memmove(&m_buffer[0], m_cursor, left);
+            if (n > m_buffer.size())
+            {
+                m_buffer.resize(n);
+            }
+            while (left < n)
+            {
+                size_t got = fill(&m_buffer[0] + left, m_buffer.size() - left);
+                if (got == 0)
+                {
+                    break;
+                }
+                left += got;
+            }
+            setg(&m_buffer[0], &m_buffer[0], &m_buffer[0] + left);
+            return left >= n;
+        }
+
+        void xsgetn (char_type* data, size_t n)
+        {
+            size_t left = static_cast<size_t>(m_end - m_cursor);
+            std::memcpy(data, m_cursor, left);
+            m_cursor += left;
+            data += left;
+            n -= left;
+            if (n < m_buffer.size())
+            {
+                basic_source::xsgetn(data, n);
+                return;
+            }
+            while (n > 0)
+            {
+                size_t got = fill(data, n);
+                if (got == 0)
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                m_offset += got;
+                data += got;
+                n -= got;
+            }
+        }
+
+        std::vector<char_type> m_buffer;
+    };
+
+    template <typename _Ttr = std::char_traits<char>>
+    class basic_istream_source : public buffered_source
+    {
+    public:
+        typedef std::basic_istream<char, _Ttr> stream_t;
+
+        explicit basic_istream_source (stream_t& stream, size_t capacity = default_capacity) : buffered_source(capacity), m_stream(stream) {}
+    protected:
+        size_t fill (char_type* data, size_t n)
+        {
+            m_stream.read(data, static_cast<std::streamsize>(n));
+            return static_cast<size_t>(m_stream.gcount());
+        }
+    private:
+        stream_t& m_stream;
+    };
+
+    typedef basic_istream_source<> istream_source;
+
+    /* Reads from a POSIX file descriptor; failures throw std::system_error.
+     * The descriptor is not owned. */
+    class fd_source : public buffered_source
+    {
+    public:
+        explicit fd_source (int fd, size_t capacity = default_capacity) : buffered_source(capacity), m_fd(fd) {}
+    protected:
+        size_t fill (char_type* data, size_t n)
+        {
+            for (;;)
+            {
+                auto got = ::read(m_fd, data, n);
+                if (got >= 0)
+                {
+                    return static_cast<size_t>(got);
+                }
+                if (errno != EINTR)
+                {
+                    throw std::system_error(errno, std::generic_category(), "read");
+                }
+            }
+        }
+    private:
+        int m_fd;
+    };
+};
+
+#endif	/* SINK_HPP */
+
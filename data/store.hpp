@@ -0,0 +1,355 @@
+/*
+ * File:   store.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 5:20 PM
+ */
+
+#ifndef STORE_HPP
+#define	STORE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./mapped_file.hpp"
+#include "./sink.hpp"
+#include "./view.hpp"
+
+/* Key-value snapshot laid out for point lookups over a memory mapping:
+ *
+ *   records  key and value of every entry back to back, in binder format
+ *   index    one slot per key, ordered by encoded key bytes:
+ *            key offset, value offset, value end
+ *   trailer  index offset, number of slots, magic
+ *
+ * Offsets and counts are 64-bit big-endian. A lookup encodes the probe key
+ * with the same binder, binary searches the index and decodes only the value
+ * it finds. */
+
+namespace data
+{
+    struct store_format
+    {
+        static const size_t slot_length = 3 * sizeof(uint64_t);
+        static const size_t trailer_length = 3 * sizeof(uint64_t);
+
+        static const char* magic ()
+        {
+            return "SOXKV001";
+        }
+
+        static void store (char* data, uint64_t x)
+        {
+            x = to_big(x);
+            std::memcpy(data, &x, sizeof(x));
+        }
+
+        static uint64_t load (const char* data)
+        {
+            uint64_t x;
+            std::memcpy(&x, data, sizeof(x));
+            return to_big(x);
+        }
+    };
+
+    /* Writes a store file entry by entry; the index is appended by close.
+     * Inserting a key again replaces the earlier value. */
+    template <typename K, typename V, typename B = default_binder>
+    class store_writer
+    {
+    public:
+        explicit store_writer (const std::string& path) : m_fd(-1)
+        {
+#if defined(_WIN32)
+            m_fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+            m_fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            if (m_fd < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "open");
+            }
+            m_sink.reset(new fd_sink(m_fd));
+        }
+
+        store_writer (const store_writer&) = delete;
+        store_writer& operator= (const store_writer&) = delete;
+
+        ~store_writer()
+        {
+            try
+            {
+                close();
+            }
+            catch (const std::exception&) {}
+        }
+
+        void insert (const K& key, const V& value)
+        {
+            __slot slot;
+            {
+                string_sink sink (slot.key);
+                m_binder(sink, key);
+            }
+            slot.key_offset = m_sink->size();
+            m_sink->write(slot.key.data(), slot.key.size());
+            slot.value_offset = m_sink->size();
+            m_binder(static_cast<basic_sink&>(*m_sink), value);
+            slot.value_end = m_sink->size();
+            m_slots.push_back(std::move(slot));
+        }
+
+        /* Appends the index and the trailer and closes the file. */
+        void close ()
+        {
+            if (m_fd < 0)
+            {
+                return;
+            }
+            int fd = m_fd;
+            m_fd = -1;
+            try
+            {
+                __write_index();
+                m_sink->flush();
+            }
+            catch (...)
+            {
+                m_sink.reset();
+                __close(fd);
+                throw;
+            }
+            m_sink.reset();
+            if (__close(fd) != 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "close");
+            }
+        }
+    private:
+        struct __slot
+        {
+            std::string key;
+            uint64_t key_offset;
+            uint64_t value_offset;
+            uint64_t value_end;
+        };
+
+        static int __close (int fd)
+        {
+#if defined(_WIN32)
+            return ::_close(fd);
+#else
+            return ::close(fd);
+#endif
+        }
+
+        void __write_index ()
+        {
+            std::stable_sort(m_slots.begin(), m_slots.end(), [] (const __slot& lhs, const __slot& rhs)
+            {
+                return lhs.key < rhs.key;
+            });
+            auto last = m_slots.begin();
+            for (auto iter = m_slots.begin(); iter != m_slots.end(); ++iter)
+            {
+                if (last != m_slots.begin() && (last - 1)->key == iter->key)
+                {
+                    --last;
+                }
+                if (last != iter)
+                {
+                    *last = std::move(*iter);
+                }
+                ++last;
+            }
+            uint64_t index_offset = m_sink->size();
+            for (auto iter = m_slots.begin(); iter != last; ++iter)
+            {
+                char* slot = m_sink->reserve(store_format::slot_length);
+                store_format::store(slot, iter->key_offset);
+                store_format::store(slot + sizeof(uint64_t), iter->value_offset);
+                store_format::store(slot + 2 * sizeof(uint64_t), iter->value_end);
+                m_sink->commit(store_format::slot_length);
+            }
+            char* trailer = m_sink->reserve(store_format::trailer_length);
+            store_format::store(trailer, index_offset);
+            store_format::store(trailer + sizeof(uint64_t), static_cast<uint64_t>(last - m_slots.begin()));
+            std::memcpy(trailer + 2 * sizeof(uint64_t), store_format::magic(), sizeof(uint64_t));
+            m_sink->commit(store_format::trailer_length);
+            m_slots.clear();
+        }
+
+        B m_binder;
+        int m_fd;
+        std::unique_ptr<fd_sink> m_sink;
+        std::vector<__slot> m_slots;
+    };
+
+    /* Writes every entry of an associative container as a store file. */
+    template <typename M>
+    void write_store (const std::string& path, const M& map)
+    {
+        store_writer<typename M::key_type, typename M::mapped_type> writer (path);
+        for (auto iter = map.begin(); iter != map.end(); ++iter)
+        {
+            writer.insert(iter->first, iter->second);
+        }
+        writer.close();
+    }
+
+    /* Read-only store opened through a memory mapping. Lookups take
+     * O(log n) key comparisons and decode nothing but the matching value. */
+    template <typename K, typename V, typename B = default_binder>
+    class store
+    {
+    public:
+        explicit store (const std::string& path) : m_file(path), m_index(nullptr), m_size(0)
+        {
+            const char* data = m_file.data();
+            size_t length = m_file.size();
+            if (length < store_format::trailer_length
+                    || std::memcmp(data + length - sizeof(uint64_t), store_format::magic(), sizeof(uint64_t)) != 0)
+            {
+                throw std::runtime_error("Not a store file.");
+            }
+            const char* trailer = data + length - store_format::trailer_length;
+            uint64_t index_offset = store_format::load(trailer);
+            uint64_t size = store_format::load(trailer + sizeof(uint64_t));
+            uint64_t index_end = length - store_format::trailer_length;
+            if (index_offset > index_end || (index_end - index_offset) / store_format::slot_length != size
+                    || (index_end - index_offset) % store_format::slot_length != 0)
+            {
+                throw std::runtime_error("Corrupted store index.");
+            }
+            m_index = data + index_offset;
+            m_size = static_cast<size_t>(size);
+        }
+
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        bool empty () const
+        {
+            return m_size == 0;
+        }
+
+        size_t count (const K& key) const
+        {
+            return __find(key) != nullptr ? 1 : 0;
+        }
+
+        /* Decodes the value stored under key into value; returns false if
+         * there is none. */
+        bool find (const K& key, V& value) const
+        {
+            const char* slot = __find(key);
+            if (slot == nullptr)
+            {
+                return false;
+            }
+            std::pair<const char*, size_t> stored = __value(slot);
+            span_source source (stored.first, stored.second);
+            B binder;
+            binder(value, source);
+            return true;
+        }
+
+        V at (const K& key) const
+        {
+            V value;
+            if (!find(key, value))
+            {
+                throw std::out_of_range("Key is not present in the store.");
+            }
+            return value;
+        }
+
+        /* Zero-copy view of the value stored under key. */
+        template <typename T = V>
+        typename view_traits<T>::type lookup (const K& key) const
+        {
+            const char* slot = __find(key);
+            if (slot == nullptr)
+            {
+                throw std::out_of_range("Key is not present in the store.");
+            }
+            std::pair<const char*, size_t> value = __value(slot);
+            return view<T>(value.first, value.second);
+        }
+    private:
+        const char* __find (const K& key) const
+        {
+            std::string probe;
+            {
+                string_sink sink (probe);
+                B binder;
+                binder(sink, key);
+            }
+            const char* data = m_file.data();
+            size_t first = 0;
+            size_t last = m_size;
+            while (first < last)
+            {
+                size_t middle = first + (last - first) / 2;
+                const char* slot = m_index + middle * store_format::slot_length;
+                uint64_t key_offset = store_format::load(slot);
+                uint64_t key_end = store_format::load(slot + sizeof(uint64_t));
+                if (key_offset > key_end || key_end > static_cast<uint64_t>(m_index - data))
+                {
+                    throw std::runtime_error("Corrupted store index.");
+                }
+                size_t key_length = static_cast<size_t>(key_end - key_offset);
+                int order = std::memcmp(data + key_offset, probe.data(), std::min(key_length, probe.size()));
+                if (order == 0)
+                {
+                    order = key_length < probe.size() ? -1 : key_length > probe.size() ? 1 : 0;
+                }
+                if (order == 0)
+                {
+                    return slot;
+                }
+                if (order < 0)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return nullptr;
+        }
+
+        std::pair<const char*, size_t> __value (const char* slot) const
+        {
+            const char* data = m_file.data();
+            uint64_t value_offset = store_format::load(slot + sizeof(uint64_t));
+            uint64_t value_end = store_format::load(slot + 2 * sizeof(uint64_t));
+            if (value_offset > value_end || value_end > static_cast<uint64_t>(m_index - data))
+            {
+                throw std::runtime_error("Corrupted store index.");
+            }
+            return std::pair<const char*, size_t>(data + value_offset, static_cast<size_t>(value_end - value_offset));
+        }
+
+        mapped_file m_file;
+        const char* m_index;
+        size_t m_size;
+    };
+};
+
+#endif	/* STORE_HPP */
+
@@ -0,0 +1,508 @@
+/*
+ * File:   struct_binder.hpp
+ * Author: Konstantin
+ *
+ * Created on October 19, 2026, 1:15 AM
+ */
+
+#ifndef STRUCT_BINDER_HPP
+#define	STRUCT_BINDER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "./serialization.hpp"
+#include "./sink.hpp"
+
+/* Field lists of user structs. After the definition of a struct, at global
+ * scope:
+ *
+ *   DATA_FIELDS(point, x, y, weight)
+ *
+ * The struct is then written as its fields in the declared order, i.e. the
+ * same bytes as a tuple of them. A struct that is trivially copyable and
+ * standard-layout, whose fields are scalars (or such structs) declared in
+ * memory order without padding between or after them, is packed: it is
+ * copied with one memcpy, and so is a whole std::vector of it, followed by
+ * an in-place byte swap of the fields only where the host order differs
+ * from the wire (never on writes of native_binder). */
+
+namespace data
+{
+    template <typename T, typename M, M T::* Member>
+    struct field
+    {
+        typedef M type;
+
+        static const M& get (const T& x)
+        {
+            return x.*Member;
+        }
+
+        static M& get (T& x)
+        {
+            return x.*Member;
+        }
+
+        /* Offset of the field in T; T need not be constructible. */
+        static size_t offset ()
+        {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            const T* object = reinterpret_cast<const T*>(&storage);
+            return static_cast<size_t>(reinterpret_cast<const char*>(&(object->*Member)) - reinterpret_cast<const char*>(object));
+        }
+    };
+
+    /* Specialized by DATA_FIELDS; type is a std::tuple of field<>s. */
+    template <typename T>
+    struct fields {};
+
+    template <typename T>
+    struct is_reflected
+    {
+        template <typename A>
+        static std::true_type __test (typename fields<A>::type*);
+
+        template <typename A>
+        static std::false_type __test (...);
+
+        typedef decltype(__test<typename std::decay<T>::type>(nullptr)) type;
+        static const bool value = type::value;
+    };
+
+    template <typename T, bool = is_reflected<T>::value>
+    struct struct_layout;
+
+    namespace __struct
+    {
+        template <typename T, bool = std::is_scalar<T>::value>
+        struct member
+        {
+            typedef std::integral_constant<bool, struct_layout<T>::candidate::value> candidate;
+            typedef std::integral_constant<bool, struct_layout<T>::bytewise::value> bytewise;
+
+            static bool contiguous ()
+            {
+                return struct_layout<T>::contiguous();
+            }
+
+            static void reverse (char* x)
+            {
+                struct_layout<T>::reverse(x, 1);
+            }
+        };
+
+        template <typename T>
+        struct member<T, true>
+        {
+            typedef std::true_type candidate;
+            typedef std::integral_constant<bool, sizeof(T) == 1> bytewise;
+
+            static bool contiguous ()
+            {
+                return true;
+            }
+
+            /* Through a copy: the bytes need not be aligned for T. */
+            static void reverse (char* x)
+            {
+                T value;
+                std::memcpy(&value, x, sizeof(T));
+                SerializableSequence<T, char>::reverse(&value, 1);
+                std::memcpy(x, &value, sizeof(T));
+            }
+        };
+
+        template <typename... F>
+        struct all;
+
+        template <>
+        struct all<>
+        {
+            static const size_t size = 0;
+            typedef std::true_type candidate;
+            typedef std::true_type bytewise;
+        };
+
+        template <typename F, typename... A>
+        struct all<F, A...>
+        {
+            typedef typename F::type type;
+
+            static const size_t size = sizeof(type) + all<A...>::size;
+            typedef std::integral_constant<bool, (std::is_scalar<type>::value || is_reflected<type>::value) && all<A...>::candidate::value> candidate;
+            typedef std::integral_constant<bool, member<type>::bytewise::value && all<A...>::bytewise::value> bytewise;
+        };
+
+        template <typename F>
+        struct all_of;
+
+        template <typename... F>
+        struct all_of<std::tuple<F...>> : public all<F...> {};
+
+        template <typename F>
+        struct types_of;
+
+        template <typename... F>
+        struct types_of<std::tuple<F...>>
+        {
+            typedef std::tuple<typename F::type...> type;
+        };
+    };
+
+    /* The tuple a reflected T is written as. */
+    template <typename T>
+    struct reflected_tuple
+    {
+        typedef typename __struct::types_of<typename fields<T>::type>::type type;
+    };
+
+    template <typename T>
+    struct struct_layout<T, false>
+    {
+        typedef std::false_type candidate;
+        typedef std::false_type bytewise;
+
+        static bool contiguous ()
+        {
+            return false;
+        }
+
+        static void reverse (char*, size_t) {}
+    };
+
+    /* candidate: the type allows packing at all; contiguous(): the fields
+     * really are laid out in the declared order (checked once); bytewise:
+     * all fields are single bytes, so no byte order applies. */
+    template <typename T>
+    struct struct_layout<T, true>
+    {
+        typedef typename fields<T>::type fields_t;
+
+        static const size_t size = std::tuple_size<fields_t>::value;
+
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value && std::is_standard_layout<T>::value
+                && __struct::all_of<fields_t>::candidate::value && __struct::all_of<fields_t>::size == sizeof(T)> candidate;
+        typedef std::integral_constant<bool, candidate::value && __struct::all_of<fields_t>::bytewise::value> bytewise;
+
+        static bool contiguous ()
+        {
+            static const bool result = candidate::value && __contiguous<0>(0);
+            return result;
+        }
+
+        /* Reverses the bytes of every field of count packed values stored
+         * from first on, in place. */
+        static void reverse (char* first, size_t count)
+        {
+            for (char* last = first + count * sizeof(T); first != last; first += sizeof(T))
+            {
+                __reverse<0>(first);
+            }
+        }
+    private:
+        template <size_t I>
+        static typename std::enable_if<I < size, bool>::type __contiguous (size_t offset)
+        {
+            typedef typename std::tuple_element<I, fields_t>::type field_t;
+            typedef typename field_t::type member_t;
+
+            return field_t::offset() == offset && __struct::member<member_t>::contiguous() && __contiguous<I + 1>(offset + sizeof(member_t));
+        }
+
+        template <size_t I>
+        static typename std::enable_if<I == size, bool>::type __contiguous (size_t offset)
+        {
+            return offset == sizeof(T);
+        }
+
+        template <size_t I>
+        static typename std::enable_if<I < size>::type __reverse (char* x)
+        {
+            typedef typename std::tuple_element<I, fields_t>::type::type member_t;
+
+            __struct::member<member_t>::reverse(x);
+            __reverse<I + 1>(x + sizeof(member_t));
+        }
+
+        template <size_t I>
+        static typename std::enable_if<I == size>::type __reverse (char*) {}
+    };
+
+    /* Binds reflected structs, and std::vectors of packed ones, which are
+     * written as sequence_binder<_St, _Order> writes any other sequence. */
+    template <typename _St = size_t, typename _Order = big_endian_wire>
+    struct struct_binder
+    {
+        typedef _St size_type;
+        typedef _Order order_type;
+
+        order_type& order ()
+        {
+            return m_order;
+        }
+
+        const order_type& order () const
+        {
+            return m_order;
+        }
+
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_reflected<T>::value, S&>::type
+        operator() (S& stream, const T& x, Cb&& callback) const
+        {
+            __write_struct(stream, x, callback, typename struct_layout<typename std::decay<T>::type>::candidate());
+            return stream;
+        }
+
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_reflected<T>::value, T&>::type
+        operator() (T& x, S& stream, Cb&& callback) const
+        {
+            __read_struct(x, stream, callback, typename struct_layout<typename std::decay<T>::type>::candidate());
+            return x;
+        }
+
+        template <typename S, typename T, typename _Alloc, typename Cb>
+        typename std::enable_if<is_output<S>::value && struct_layout<T>::candidate::value, S&>::type
+        operator() (S& stream, const std::vector<T, _Alloc>& x, Cb&& callback) const
+        {
+            size_type length {};
+            __set_length(length, x.size());
+            callback(stream, length);
+            if (struct_layout<T>::contiguous())
+            {
+                __write(stream, x.data(), x.size(), m_order.reverse_on_write());
+            }
+            else
+            {
+                for (const T& element : x)
+                {
+                    callback(stream, element);
+                }
+            }
+            return stream;
+        }
+
+        /* Grown in geometrically increasing chunks like the bulk sequences
+         * of sequence_binder, so a corrupted length fails on the stream. */
+        template <typename T, typename _Alloc, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && struct_layout<T>::candidate::value, std::vector<T, _Alloc>&>::type
+        operator() (std::vector<T, _Alloc>& x, S& stream, Cb&& callback) const
+        {
+            size_type length {};
+            callback(length, stream);
+            x.clear();
+            for (size_t left = __get_length(length), done = 0, step; left > 0 && __good(stream); left -= step, done += step)
+            {
+                step = std::min(left, std::max(__chunk_length / sizeof(T), done));
+                x.resize(done + step);
+                if (struct_layout<T>::contiguous())
+                {
+                    x.resize(done + __read(stream, x.data() + done, step, m_order.reverse_on_read()));
+                }
+                else
+                {
+                    for (size_t i = done; i < done + step; ++i)
+                    {
+                        callback(x[i], stream);
+                    }
+                }
+            }
+            return x;
+        }
+    private:
+        static const size_t __chunk_length = 4096;
+
+        template <typename T>
+        static void __write (basic_sink& sink, const T* first, size_t count, bool reverse)
+        {
+            if (struct_layout<T>::bytewise::value || !reverse)
+            {
+                sink.write(reinterpret_cast<const basic_sink::char_type*>(first), count * sizeof(T));
+                return;
+            }
+            for (size_t left = count, step; left > 0; left -= step, first += step)
+            {
+                step = std::min(left, std::max<size_t>(__chunk_length / sizeof(T), 1));
+                char* window = reinterpret_cast<char*>(sink.reserve(step * sizeof(T)));
+                std::memcpy(window, first, step * sizeof(T));
+                struct_layout<T>::reverse(window, step);
+                sink.commit(step * sizeof(T));
+            }
+        }
+
+        template <typename T, typename _Tch, typename _Ttr>
+        static void __write (std::basic_ostream<_Tch, _Ttr>& stream, const T* first, size_t count, bool reverse)
+        {
+            static_assert(sizeof(_Tch) == 1, "Packed structs need a byte stream");
+            if (struct_layout<T>::bytewise::value || !reverse)
+            {
+                stream.write(reinterpret_cast<const _Tch*>(first), count * sizeof(T));
+                return;
+            }
+            T chunk [std::max<size_t>(__chunk_length / sizeof(T), 1)];
+            for (size_t left = count, step; left > 0; left -= step, first += step)
+            {
+                step = std::min(left, sizeof(chunk) / sizeof(T));
+                std::memcpy(chunk, first, step * sizeof(T));
+                struct_layout<T>::reverse(reinterpret_cast<char*>(chunk), step);
+                stream.write(reinterpret_cast<const _Tch*>(chunk), step * sizeof(T));
+            }
+        }
+
+        /* Both return the number of whole values read. */
+        template <typename T>
+        static size_t __read (basic_source& source, T* first, size_t count, bool reverse)
+        {
+            source.read(reinterpret_cast<basic_source::char_type*>(first), count * sizeof(T));
+            struct_layout<T>::reverse(reinterpret_cast<char*>(first), struct_layout<T>::bytewise::value || !reverse ? 0 : count);
+            return count;
+        }
+
+        template <typename T, typename _Tch, typename _Ttr>
+        static size_t __read (std::basic_istream<_Tch, _Ttr>& stream, T* first, size_t count, bool reverse)
+        {
+            static_assert(sizeof(_Tch) == 1, "Packed structs need a byte stream");
+            stream.read(reinterpret_cast<_Tch*>(first), count * sizeof(T));
+            count = static_cast<size_t>(stream.gcount()) / sizeof(T);
+            struct_layout<T>::reverse(reinterpret_cast<char*>(first), struct_layout<T>::bytewise::value || !reverse ? 0 : count);
+            return count;
+        }
+
+        template <typename S, typename T, typename Cb>
+        void __write_struct (S& stream, const T& x, Cb& callback, std::true_type) const
+        {
+            if (struct_layout<T>::contiguous())
+            {
+                __write(stream, &x, 1, m_order.reverse_on_write());
+            }
+            else
+            {
+                __write_fields<0>(stream, x, callback);
+            }
+        }
+
+        template <typename S, typename T, typename Cb>
+        static void __write_struct (S& stream, const T& x, Cb& callback, std::false_type)
+        {
+            __write_fields<0>(stream, x, callback);
+        }
+
+        template <typename T, typename S, typename Cb>
+        void __read_struct (T& x, S& stream, Cb& callback, std::true_type) const
+        {
+            if (struct_layout<T>::contiguous())
+            {
+                __read(stream, &x, 1, m_order.reverse_on_read());
+            }
+            else
+            {
+                __read_fields<0>(x, stream, callback);
+            }
+        }
+
+        template <typename T, typename S, typename Cb>
+        static void __read_struct (T& x, S& stream, Cb& callback, std::false_type)
+        {
+            __read_fields<0>(x, stream, callback);
+        }
+
+        template <size_t I, typename S, typename T, typename Cb>
+        static typename std::enable_if<I < struct_layout<T>::size>::type __write_fields (S& stream, const T& x, Cb& callback)
+        {
+            callback(stream, std::tuple_element<I, typename fields<T>::type>::type::get(x));
+            __write_fields<I + 1>(stream, x, callback);
+        }
+
+        template <size_t I, typename S, typename T, typename Cb>
+        static typename std::enable_if<I == struct_layout<T>::size>::type __write_fields (S&, const T&, Cb&) {}
+
+        template <size_t I, typename T, typename S, typename Cb>
+        static typename std::enable_if<I < struct_layout<T>::size>::type __read_fields (T& x, S& stream, Cb& callback)
+        {
+            callback(std::tuple_element<I, typename fields<T>::type>::type::get(x), stream);
+            __read_fields<I + 1>(x, stream, callback);
+        }
+
+        template <size_t I, typename T, typename S, typename Cb>
+        static typename std::enable_if<I == struct_layout<T>::size>::type __read_fields (T&, S&, Cb&) {}
+
+        static void __set_length (length_type& length, size_t value)
+        {
+            length.value = value;
+        }
+
+        template <typename L>
+        static void __set_length (L& length, size_t value)
+        {
+            length = static_cast<L>(value);
+        }
+
+        static size_t __get_length (const length_type& length)
+        {
+            return length.value;
+        }
+
+        template <typename L>
+        static size_t __get_length (const L& length)
+        {
+            return static_cast<size_t>(length);
+        }
+
+        template <typename _Tch, typename _Ttr>
+        static bool __good (const std::basic_istream<_Tch, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+
+        order_type m_order;
+    };
+};
+
+#define DATA_FIELDS_CAT(a, b) DATA_FIELDS_CAT_(a, b)
+#define DATA_FIELDS_CAT_(a, b) a##b
+#define DATA_FIELDS_COUNT(...) DATA_FIELDS_COUNT_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DATA_FIELDS_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, N, ...) N
+
+#define DATA_FIELD_1(T, x) ::data::field<T, decltype(T::x), &T::x>
+#define DATA_FIELD_2(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_1(T, __VA_ARGS__)
+#define DATA_FIELD_3(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_2(T, __VA_ARGS__)
+#define DATA_FIELD_4(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_3(T, __VA_ARGS__)
+#define DATA_FIELD_5(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_4(T, __VA_ARGS__)
+#define DATA_FIELD_6(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_5(T, __VA_ARGS__)
+#define DATA_FIELD_7(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_6(T, __VA_ARGS__)
+#define DATA_FIELD_8(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_7(T, __VA_ARGS__)
+#define DATA_FIELD_9(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_8(T, __VA_ARGS__)
+#define DATA_FIELD_10(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_9(T, __VA_ARGS__)
+#define DATA_FIELD_11(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_10(T, __VA_ARGS__)
+#define DATA_FIELD_12(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_11(T, __VA_ARGS__)
+#define DATA_FIELD_13(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_12(T, __VA_ARGS__)
+#define DATA_FIELD_14(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_13(T, __VA_ARGS__)
+#define DATA_FIELD_15(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_14(T, __VA_ARGS__)
+#define DATA_FIELD_16(T, x, ...) DATA_FIELD_1(T, x), DATA_FIELD_15(T, __VA_ARGS__)
+
+/* Declares the fields of T, up to 16, in wire order; T must not contain a
+ * top-level comma (use a typedef for templates). */
+#define DATA_FIELDS(T, ...) \
+    namespace data \
+    { \
+        template <> \
+        struct fields<T> \
+        { \
+            typedef std::tuple<DATA_FIELDS_CAT(DATA_FIELD_, DATA_FIELDS_COUNT(__VA_ARGS__))(T, __VA_ARGS__)> type; \
+        }; \
+    }
+
+#endif	/* STRUCT_BINDER_HPP */
+
@@ -0,0 +1,198 @@
+/*
+ * File:   thread_pool.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 6:40 PM
+ */
+
+#ifndef THREAD_POOL_HPP
+#define	THREAD_POOL_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace data
+{
+    /* Fixed set of workers, each with its own task deque. A worker takes
+     * its newest task first and, once its deque runs dry, steals the oldest
+     * task of another worker. Tasks submitted from outside are spread round
+     * robin; tasks submitted by a worker go to its own deque.
+     *
+     * The count of queued tasks is atomic: submitting and taking a task
+     * touch only the deques and that count, and the pool-wide mutex is
+     * locked only to put an idle worker to sleep or to wake one.
+     *
+     * Blocking on a future from inside a task may deadlock a small pool, so
+     * results should be collected by the submitting thread. */
+    class thread_pool
+    {
+    public:
+        explicit thread_pool (size_t threads = std::thread::hardware_concurrency()) : m_pending(0), m_sleeping(0), m_stop(false), m_next(0)
+        {
+            threads = std::max<size_t>(threads, 1);
+            for (size_t i = 0; i < threads; ++i)
+            {
+                m_queues.emplace_back(new __queue());
+            }
+            for (size_t i = 0; i < threads; ++i)
+            {
+                m_threads.emplace_back(&thread_pool::__run, this, i);
+            }
+        }
+
+        thread_pool (const thread_pool&) = delete;
+        thread_pool& operator= (const thread_pool&) = delete;
+
+        /* Runs every task submitted so far, then joins the workers. */
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock (m_mutex);
+                m_stop = true;
+            }
+            m_ready.notify_all();
+            for (std::thread& thread : m_threads)
+            {
+                thread.join();
+            }
+        }
+
+        size_t size () const
+        {
+            return m_threads.size();
+        }
+
+        template <typename F>
+        std::future<decltype(std::declval<typename std::decay<F>::type&>()())> submit (F&& f)
+        {
+            typedef decltype(std::declval<typename std::decay<F>::type&>()()) result_t;
+
+            std::shared_ptr<std::packaged_task<result_t()>> task (new std::packaged_task<result_t()>(std::forward<F>(f)));
+            std::future<result_t> result = task->get_future();
+            __worker& current = __current();
+            size_t index = current.pool == this ? current.index : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+            {
+                std::lock_guard<std::mutex> lock (m_queues[index]->mutex);
+                m_queues[index]->tasks.emplace_back([task] () { (*task)(); });
+            }
+            m_pending.fetch_add(1);
+            /* Pairs with the sleeper count raised before the sleeper's last
+             * look at m_pending: one of the two sides sees the other. */
+            if (m_sleeping.load() > 0)
+            {
+                {
+                    std::lock_guard<std::mutex> lock (m_mutex);
+                }
+                m_ready.notify_one();
+            }
+            return result;
+        }
+    private:
+        struct __queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        struct __worker
+        {
+            thread_pool* pool;
+            size_t index;
+        };
+
+        static __worker& __current ()
+        {
+            static thread_local __worker worker {nullptr, 0};
+            return worker;
+        }
+
+        void __run (size_t index)
+        {
+            __current() = __worker {this, index};
+            std::function<void()> task;
+            while (true)
+            {
+                if (__claim())
+                {
+                    while (!__take(index, task));
+                    task();
+                    task = nullptr;
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock (m_mutex);
+                m_sleeping.fetch_add(1);
+                m_ready.wait(lock, [this] () { return m_pending.load() > 0 || m_stop; });
+                m_sleeping.fetch_sub(1);
+                if (m_pending.load() == 0)
+                {
+                    return;
+                }
+            }
+        }
+
+        /* Takes the right to one queued task. */
+        bool __claim ()
+        {
+            size_t pending = m_pending.load(std::memory_order_relaxed);
+            while (pending > 0)
+            {
+                if (m_pending.compare_exchange_weak(pending, pending - 1))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /* A claimed task is always in some deque, but another worker may
+         * move ahead of us for a particular one, hence the retry loop. */
+        bool __take (size_t index, std::function<void()>& task)
+        {
+            {
+                __queue& own = *m_queues[index];
+                std::lock_guard<std::mutex> lock (own.mutex);
+                if (!own.tasks.empty())
+                {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (size_t i = 1; i < m_queues.size(); ++i)
+            {
+                __queue& victim = *m_queues[(index + i) % m_queues.size()];
+                std::lock_guard<std::mutex> lock (victim.mutex);
+                if (!victim.tasks.empty())
+                {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        std::vector<std::unique_ptr<__queue>> m_queues;
+        std::vector<std::thread> m_threads;
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::atomic<size_t> m_pending;
+        std::atomic<size_t> m_sleeping;
+        bool m_stop;
+        std::atomic<size_t> m_next;
+    };
+};
+
+#endif	/* THREAD_POOL_HPP */
+
@@ -0,0 +1,194 @@
+/*
+ * File:   varint.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 4:10 PM
+ */
+
+#ifndef VARINT_HPP
+#define	VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "./byte_order.hpp"
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace data
+{
+    /* Base-128 integers, least significant group first, with the high bit
+     * of every byte but the last set. This is the layout length_binder has
+     * always written for byte streams. */
+    struct varint
+    {
+        static const size_t max_length = 10;
+
+        static constexpr size_t encoded_length (uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return 1 + static_cast<size_t>(63 - __builtin_clzll(x | 1)) / 7;
+#else
+            return x < 0x80 ? 1 : 1 + encoded_length(x >> 7);
+#endif
+        }
+
+        /* Writes encoded_length(x) bytes to out and returns their number. */
+        static size_t encode (uint64_t x, char* out)
+        {
+            if (x < 0x80)
+            {
+                *out = static_cast<char>(x);
+                return 1;
+            }
+            const size_t length = encoded_length(x);
+            for (size_t i = 0; i + 1 < length; ++i, x >>= 7)
+            {
+                out[i] = static_cast<char>(x | 0x80);
+            }
+            out[length - 1] = static_cast<char>(x);
+            return length;
+        }
+
+        /* Decodes the integer starting at first and returns the position past
+         * it. Input ending inside the encoding throws std::out_of_range; more
+         * than max_length bytes or bits beyond 64 throw std::overflow_error. */
+        static const char* decode (const char* first, const char* last, uint64_t& x)
+        {
+            if (first != last && !(*first & 0x80))
+            {
+                x = static_cast<unsigned char>(*first);
+                return first + 1;
+            }
+            if (last - first >= 2 && !(first[1] & 0x80))
+            {
+                x = (static_cast<unsigned char>(first[0]) & 0x7f) | (uint64_t(static_cast<unsigned char>(first[1])) << 7);
+                return first + 2;
+            }
+            if (last - first >= 8)
+            {
+                return __decode_word(first, last, x);
+            }
+            return __decode_bytes(first, last, x);
+        }
+        /* Bit scans of a nonzero x. */
+        static unsigned count_leading_zeros (uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_clzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanReverse64(&index, x);
+            return 63 - static_cast<unsigned>(index);
+#else
+            unsigned result = 0;
+            for (; !(x >> 63); x <<= 1, ++result);
+            return result;
+#endif
+        }
+
+        static unsigned count_trailing_zeros (uint64_t x)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            _BitScanForward64(&index, x);
+            return static_cast<unsigned>(index);
+#else
+            unsigned result = 0;
+            for (; !(x & 1); x >>= 1, ++result);
+            return result;
+#endif
+        }
+    private:
+        static const uint64_t __stop_bits = 0x8080808080808080ull;
+        static const uint64_t __payload_bits = 0x7f7f7f7f7f7f7f7full;
+
+        /* Packs the low 7 bits of every byte of x next to each other. */
+        static uint64_t __compact (uint64_t x)
+        {
+#if defined(__BMI2__)
+            return _pext_u64(x, __payload_bits);
+#else
+            x &= __payload_bits;
+            return (x & 0x7full)
+                    | ((x >> 1) & 0x3f80ull)
+                    | ((x >> 2) & 0x1fc000ull)
+                    | ((x >> 3) & 0xfe00000ull)
+                    | ((x >> 4) & 0x7f0000000ull)
+                    | ((x >> 5) & 0x3f800000000ull)
+                    | ((x >> 6) & 0x1fc0000000000ull)
+                    | ((x >> 7) & 0xfe000000000000ull);
+#endif
+        }
+
+        /* At least 8 bytes are readable: the terminating byte is located with
+         * one trailing-zero count over the whole word. */
+        static const char* __decode_word (const char* first, const char* last, uint64_t& x)
+        {
+            uint64_t word;
+            std::memcpy(&word, first, sizeof(word));
+            word = to_little(word);
+            const uint64_t stop = ~word & __stop_bits;
+            if (stop != 0)
+            {
+                const unsigned bits = count_trailing_zeros(stop) + 1;
+                x = __compact(word & (~uint64_t(0) >> (64 - bits)));
+                return first + bits / 8;
+            }
+            x = __compact(word);
+            first += 8;
+            for (unsigned shift = 56; ; shift += 7)
+            {
+                if (first == last)
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                const uint64_t chunk = static_cast<unsigned char>(*first++);
+                if (shift == 63 && chunk > 1)
+                {
+                    throw std::overflow_error("Varint exceeds 64 bits.");
+                }
+                x |= (chunk & 0x7f) << shift;
+                if (!(chunk & 0x80))
+                {
+                    return first;
+                }
+            }
+        }
+
+        static const char* __decode_bytes (const char* first, const char* last, uint64_t& x)
+        {
+            uint64_t value = 0;
+            for (unsigned shift = 0; ; shift += 7)
+            {
+                if (first == last)
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                const uint64_t chunk = static_cast<unsigned char>(*first++);
+                if (shift == 63 && chunk > 1)
+                {
+                    throw std::overflow_error("Varint exceeds 64 bits.");
+                }
+                value |= (chunk & 0x7f) << shift;
+                if (!(chunk & 0x80))
+                {
+                    x = value;
+                    return first;
+                }
+            }
+        }
+    };
+};
+
+#endif	/* VARINT_HPP */
+
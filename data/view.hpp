@@ -0,0 +1,1136 @@
+/*
+ * File:   view.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 1:55 PM
+ */
+
+#ifndef VIEW_HPP
+#define	VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <tuple>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./serialized_size.hpp"
+
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+/* Views decode the layout written by default_binder (tuple_binder,
+ * indexed_binder, sequence_binder<length_type>, length_binder, trivial_binder)
+ * straight from a contiguous buffer. They never allocate and stay valid only
+ * as long as the buffer does; own() materializes the corresponding value.
+ *
+ * Scalars and offset tables are read in the order of the wire policy W,
+ * big_endian_wire unless given. A native_binder stream is in the order its
+ * header names (native_header::decode), so one written on a little-endian
+ * host is viewed past its header with view<T, little_endian_wire>. */
+
+namespace data
+{
+    class string_view
+    {
+    public:
+        typedef char value_type;
+        typedef const char* iterator;
+        typedef const char* const_iterator;
+
+        string_view() : m_data(nullptr), m_size(0) {}
+        string_view (const char* data, size_t size) : m_data(data), m_size(size) {}
+        string_view (const char* data) : m_data(data), m_size(std::strlen(data)) {}
+        string_view (const std::string& x) : m_data(x.data()), m_size(x.size()) {}
+
+        const char* data () const
+        {
+            return m_data;
+        }
+
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        bool empty () const
+        {
+            return m_size == 0;
+        }
+
+        const_iterator begin () const
+        {
+            return m_data;
+        }
+
+        const_iterator end () const
+        {
+            return m_data + m_size;
+        }
+
+        char operator[] (size_t i) const
+        {
+            return m_data[i];
+        }
+
+        int compare (string_view x) const
+        {
+            int result = std::char_traits<char>::compare(m_data, x.m_data, m_size < x.m_size ? m_size : x.m_size);
+            return result != 0 ? result : (m_size < x.m_size ? -1 : (m_size > x.m_size ? 1 : 0));
+        }
+
+        std::string own () const
+        {
+            return std::string(m_data, m_size);
+        }
+
+#if __cplusplus >= 201703L
+        operator std::string_view () const
+        {
+            return std::string_view(m_data, m_size);
+        }
+#endif
+    private:
+        const char* m_data;
+        size_t m_size;
+    };
+
+    inline bool operator== (string_view lhs, string_view rhs)
+    {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    inline bool operator!= (string_view lhs, string_view rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    inline bool operator< (string_view lhs, string_view rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    inline std::ostream& operator<< (std::ostream& stream, string_view x)
+    {
+        return stream.write(x.data(), static_cast<std::streamsize>(x.size()));
+    }
+
+    /* Serialized scalars are kept in wire order and converted on access. */
+    template <typename C, typename W = big_endian_wire>
+    class scalar_span
+    {
+    public:
+        typedef typename C::value_type value_type;
+        typedef SerializableSequence<value_type, char> serializer_t;
+
+        class const_iterator
+        {
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef typename scalar_span::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef value_type reference;
+
+            const_iterator() : m_data(nullptr) {}
+            explicit const_iterator (const char* data) : m_data(data) {}
+
+            value_type operator* () const
+            {
+                return scalar_span::__load(m_data);
+            }
+
+            value_type operator[] (difference_type i) const
+            {
+                return scalar_span::__load(m_data + i * sizeof(value_type));
+            }
+
+            const_iterator& operator++ ()
+            {
+                m_data += sizeof(value_type);
+                return *this;
+            }
+
+            const_iterator operator++ (int)
+            {
+                const_iterator temp (*this);
+                ++*this;
+                return temp;
+            }
+
+            const_iterator& operator-- ()
+            {
+                m_data -= sizeof(value_type);
+                return *this;
+            }
+
+            const_iterator operator-- (int)
+            {
+                const_iterator temp (*this);
+                --*this;
+                return temp;
+            }
+
+            const_iterator& operator+= (difference_type n)
+            {
+                m_data += n * static_cast<difference_type>(sizeof(value_type));
+                return *this;
+            }
+
+            const_iterator& operator-= (difference_type n)
+            {
+                return *this += -n;
+            }
+
+            const_iterator operator+ (difference_type n) const
+            {
+                return const_iterator(*this) += n;
+            }
+
+            const_iterator operator- (difference_type n) const
+            {
+                return const_iterator(*this) -= n;
+            }
+
+            difference_type operator- (const_iterator x) const
+            {
+                return (m_data - x.m_data) / static_cast<difference_type>(sizeof(value_type));
+            }
+
+            bool operator== (const_iterator x) const
+            {
+                return m_data == x.m_data;
+            }
+
+            bool operator!= (const_iterator x) const
+            {
+                return m_data != x.m_data;
+            }
+
+            bool operator< (const_iterator x) const
+            {
+                return m_data < x.m_data;
+            }
+        private:
+            const char* m_data;
+        };
+
+        typedef const_iterator iterator;
+
+        scalar_span() : m_data(nullptr), m_size(0) {}
+        scalar_span (const char* data, size_t size) : m_data(data), m_size(size) {}
+
+        /* Raw serialized bytes, size() * sizeof(value_type) of them. */
+        const char* data () const
+        {
+            return m_data;
+        }
+
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        bool empty () const
+        {
+            return m_size == 0;
+        }
+
+        value_type operator[] (size_t i) const
+        {
+            return __load(m_data + i * sizeof(value_type));
+        }
+
+        const_iterator begin () const
+        {
+            return const_iterator(m_data);
+        }
+
+        const_iterator end () const
+        {
+            return const_iterator(m_data + m_size * sizeof(value_type));
+        }
+
+        C own () const
+        {
+            C result;
+            if (m_size > 0)
+            {
+                result.resize(m_size);
+                std::memcpy(&result[0], m_data, m_size * sizeof(value_type));
+                if (W::reverse_on_read())
+                {
+                    serializer_t::reverse(&result[0], m_size);
+                }
+            }
+            return result;
+        }
+    private:
+        static value_type __load (const char* data)
+        {
+            serializer_t serializer;
+            std::memcpy(serializer.sequence, data, sizeof(value_type));
+            if (W::reverse_on_read())
+            {
+                serializer.reverse();
+            }
+            return serializer.value;
+        }
+
+        const char* m_data;
+        size_t m_size;
+    };
+
+    template <typename T, typename W = big_endian_wire>
+    struct view_traits;
+
+    /* Lazily decoded sequence: elements are parsed while iterating. */
+    template <typename C, typename W = big_endian_wire>
+    class sequence_view
+    {
+    public:
+        typedef typename C::value_type element_t;
+        typedef view_traits<element_t, W> traits_t;
+        typedef typename traits_t::type value_type;
+
+        class const_iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef typename sequence_view::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const value_type* pointer;
+            typedef const value_type& reference;
+
+            const_iterator() : m_cursor(nullptr), m_end(nullptr), m_left(0), m_value() {}
+            const_iterator (const char* cursor, const char* end, size_t left) : m_cursor(cursor), m_end(end), m_left(left), m_value()
+            {
+                if (m_left > 0)
+                {
+                    m_value = traits_t::read(m_cursor, m_end);
+                }
+            }
+
+            reference operator* () const
+            {
+                return m_value;
+            }
+
+            pointer operator-> () const
+            {
+                return &m_value;
+            }
+
+            const_iterator& operator++ ()
+            {
+                if (--m_left > 0)
+                {
+                    m_value = traits_t::read(m_cursor, m_end);
+                }
+                return *this;
+            }
+
+            const_iterator operator++ (int)
+            {
+                const_iterator temp (*this);
+                ++*this;
+                return temp;
+            }
+
+            bool operator== (const const_iterator& x) const
+            {
+                return m_left == x.m_left;
+            }
+
+            bool operator!= (const const_iterator& x) const
+            {
+                return m_left != x.m_left;
+            }
+        private:
+            const char* m_cursor;
+            const char* m_end;
+            size_t m_left;
+            value_type m_value;
+        };
+
+        typedef const_iterator iterator;
+
+        sequence_view() : m_data(nullptr), m_end(nullptr), m_size(0) {}
+        sequence_view (const char* data, const char* end, size_t size) : m_data(data), m_end(end), m_size(size) {}
+
+        size_t size () const
+        {
+            return m_size;
+        }
+
+        bool empty () const
+        {
+            return m_size == 0;
+        }
+
+        const_iterator begin () const
+        {
+            return const_iterator(m_data, m_end, m_size);
+        }
+
+        const_iterator end () const
+        {
+            return const_iterator();
+        }
+
+        C own () const
+        {
+            C result;
+            for (const_iterator iter = begin(); iter != end(); ++iter)
+            {
+                result.insert(result.end(), traits_t::own(*iter));
+            }
+            return result;
+        }
+    protected:
+        const char* m_data;
+        const char* m_end;
+        size_t m_size;
+    };
+
+    namespace __view
+    {
+        /* Maps serialized in operator< order of their keys. */
+        template <typename C>
+        struct is_sorted
+        {
+            template <typename A>
+            static typename std::is_same<typename A::key_compare, std::less<typename A::key_type>>::type test (typename A::key_compare*);
+
+            template <typename A>
+            static std::false_type test (...);
+
+            typedef decltype(test<C>(nullptr)) type;
+            static const bool value = type::value;
+        };
+
+        /* First entry from iter on whose key is not less than key. */
+        template <typename I, typename K>
+        I lower_bound (I iter, I end, const K& key)
+        {
+            while (iter != end && iter->first < key)
+            {
+                ++iter;
+            }
+            return iter;
+        }
+    };
+
+    /* Sequence view over serialized associative containers with key lookup;
+     * nothing but the matching value gets decoded. Sorted maps are bisected
+     * when their entries have a fixed size and scanned up to the first key
+     * past the one looked up otherwise; indexed<map> bisects its offset
+     * table (see indexed_view). Unordered ones are scanned in full.
+     *
+     * find is thus linear for entries of variable size (string keys or
+     * values): repeated point lookups there want indexed<map> or a store. */
+    template <typename C, typename W = big_endian_wire>
+    class map_view : public sequence_view<C, W>
+    {
+    public:
+        typedef sequence_view<C, W> base_t;
+        typedef typename base_t::const_iterator const_iterator;
+        typedef typename view_traits<typename C::mapped_type, W>::type mapped_type;
+
+        map_view() {}
+        map_view (const char* data, const char* end, size_t size) : base_t(data, end, size) {}
+
+        template <typename K>
+        const_iterator find (const K& key) const
+        {
+            const_iterator iter = __find(key, typename __view::is_sorted<C>::type());
+            return iter != base_t::end() && iter->first == key ? iter : base_t::end();
+        }
+
+        template <typename K>
+        size_t count (const K& key) const
+        {
+            size_t result = 0;
+            for (const_iterator iter = find(key); iter != base_t::end() && iter->first == key; ++iter)
+            {
+                ++result;
+            }
+            return result;
+        }
+
+        template <typename K>
+        mapped_type at (const K& key) const
+        {
+            const_iterator iter = find(key);
+            if (iter == base_t::end())
+            {
+                throw std::out_of_range("Key is not present in the view.");
+            }
+            return iter->second;
+        }
+    private:
+        typedef view_traits<typename C::key_type, W> key_traits;
+
+        /* Lands on the first entry with the key, if there is one. */
+        template <typename K>
+        const_iterator __find (const K& key, std::false_type) const
+        {
+            const_iterator iter = base_t::begin();
+            while (iter != base_t::end() && !(iter->first == key))
+            {
+                ++iter;
+            }
+            return iter;
+        }
+
+        template <typename K>
+        const_iterator __find (const K& key, std::true_type) const
+        {
+            const size_t element_size = base_t::traits_t::fixed_size;
+            if (element_size == 0)
+            {
+                return __view::lower_bound(base_t::begin(), base_t::end(), key);
+            }
+            size_t first = 0;
+            size_t last = base_t::m_size;
+            while (first < last)
+            {
+                const size_t middle = first + (last - first) / 2;
+                const char* cursor = base_t::m_data + middle * element_size;
+                if (key_traits::read(cursor, base_t::m_end) < key)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            return first < base_t::m_size ? const_iterator(base_t::m_data + first * element_size, base_t::m_end, base_t::m_size - first) : base_t::end();
+        }
+    };
+
+    /* View over an indexed<C>. Element i is reached through the offset table
+     * by skipping less than one block, or directly when the elements have a
+     * fixed size, so reading the tail costs nothing for the head. */
+    template <typename C, typename W = big_endian_wire>
+    class indexed_view : public sequence_view<C, W>
+    {
+    public:
+        typedef sequence_view<C, W> base_t;
+        typedef typename base_t::traits_t traits_t;
+        typedef typename base_t::value_type value_type;
+
+        indexed_view() : m_table(nullptr), m_block(1) {}
+        indexed_view (const char* table, size_t block, const char* data, const char* end, size_t size) : base_t(data, end, size), m_table(table), m_block(block) {}
+
+        value_type operator[] (size_t i) const
+        {
+            const char* cursor = __seek(i);
+            return traits_t::read(cursor, base_t::m_end);
+        }
+
+        value_type at (size_t i) const
+        {
+            if (i >= base_t::m_size)
+            {
+                throw std::out_of_range("Index is out of the view.");
+            }
+            return (*this)[i];
+        }
+
+        /* Elements [first, last) as a lazily decoded sequence. */
+        base_t range (size_t first, size_t last) const
+        {
+            if (first > last || last > base_t::m_size)
+            {
+                throw std::out_of_range("Index is out of the view.");
+            }
+            if (first == last)
+            {
+                return base_t();
+            }
+            return base_t(__seek(first), base_t::m_end, last - first);
+        }
+
+        /* The last n elements, or all of them if there are fewer. */
+        base_t tail (size_t n) const
+        {
+            n = std::min(n, base_t::m_size);
+            return range(base_t::m_size - n, base_t::m_size);
+        }
+
+        /* Key lookup in a map kept in operator< order: the first keys of
+         * the blocks are bisected through the offset table and the scan
+         * starts one block before the first that is not less than key. */
+        template <typename K, typename M = C>
+        typename std::enable_if<__view::is_sorted<M>::value, typename base_t::const_iterator>::type find (const K& key) const
+        {
+            typedef view_traits<typename M::key_type, W> key_traits;
+
+            if (base_t::m_size == 0)
+            {
+                return base_t::end();
+            }
+            size_t first = 0;
+            size_t last = (base_t::m_size - 1) / m_block + 1;
+            while (first < last)
+            {
+                const size_t middle = first + (last - first) / 2;
+                const char* cursor = __seek(middle * m_block);
+                if (key_traits::read(cursor, base_t::m_end) < key)
+                {
+                    first = middle + 1;
+                }
+                else
+                {
+                    last = middle;
+                }
+            }
+            const size_t i = first == 0 ? 0 : (first - 1) * m_block;
+            typename base_t::const_iterator iter = __view::lower_bound(typename base_t::const_iterator(__seek(i), base_t::m_end, base_t::m_size - i), base_t::end(), key);
+            return iter != base_t::end() && iter->first == key ? iter : base_t::end();
+        }
+
+        template <typename K, typename M = C>
+        typename std::enable_if<__view::is_sorted<M>::value, size_t>::type count (const K& key) const
+        {
+            size_t result = 0;
+            for (typename base_t::const_iterator iter = find(key); iter != base_t::end() && iter->first == key; ++iter)
+            {
+                ++result;
+            }
+            return result;
+        }
+
+        template <typename K, typename M = C>
+        typename std::enable_if<__view::is_sorted<M>::value, typename view_traits<typename M::mapped_type, W>::type>::type at (const K& key) const
+        {
+            typename base_t::const_iterator iter = find(key);
+            if (iter == base_t::end())
+            {
+                throw std::out_of_range("Key is not present in the view.");
+            }
+            return iter->second;
+        }
+    private:
+        const char* __seek (size_t i) const
+        {
+            const size_t element_size = traits_t::fixed_size;
+            if (element_size > 0)
+            {
+                return base_t::m_data + i * element_size;
+            }
+            SerializableSequence<uint64_t, char> serializer;
+            std::memcpy(serializer.sequence, m_table + (i / m_block) * sizeof(uint64_t), sizeof(uint64_t));
+            if (W::reverse_on_read())
+            {
+                serializer.reverse();
+            }
+            if (serializer.value > static_cast<uint64_t>(base_t::m_end - base_t::m_data))
+            {
+                throw std::out_of_range("Unexpected end of input.");
+            }
+            const char* cursor = base_t::m_data + serializer.value;
+            for (size_t left = i % m_block; left > 0; --left)
+            {
+                traits_t::skip(cursor, base_t::m_end);
+            }
+            return cursor;
+        }
+
+        const char* m_table;
+        size_t m_block;
+    };
+
+    template <typename T1, typename T2, typename W = big_endian_wire>
+    struct pair_view
+    {
+        typedef typename std::remove_cv<T1>::type first_t;
+        typedef typename std::remove_cv<T2>::type second_t;
+        typedef typename view_traits<first_t, W>::type first_type;
+        typedef typename view_traits<second_t, W>::type second_type;
+
+        pair_view() : first(), second() {}
+        pair_view (const first_type& x, const second_type& y) : first(x), second(y) {}
+
+        std::pair<first_t, second_t> own () const
+        {
+            return std::pair<first_t, second_t>(view_traits<first_t, W>::own(first), view_traits<second_t, W>::own(second));
+        }
+
+        first_type first;
+        second_type second;
+    };
+
+    /* Tuple fields are located on access by skipping the preceding ones. */
+    template <typename W, typename... A>
+    class basic_tuple_view
+    {
+    public:
+        typedef std::tuple<A...> tuple_t;
+
+        template <size_t I>
+        struct element
+        {
+            typedef typename std::tuple_element<I, tuple_t>::type base_t;
+            typedef typename view_traits<base_t, W>::type type;
+        };
+
+        basic_tuple_view() : m_data(nullptr), m_end(nullptr) {}
+        basic_tuple_view (const char* data, const char* end) : m_data(data), m_end(end) {}
+
+        template <size_t I>
+        typename element<I>::type get () const
+        {
+            const char* cursor = m_data;
+            __skip<0, I>(cursor);
+            return view_traits<typename element<I>::base_t, W>::read(cursor, m_end);
+        }
+
+        tuple_t own () const
+        {
+            tuple_t result;
+            const char* cursor = m_data;
+            __own<0>(result, cursor);
+            return result;
+        }
+    private:
+        template <size_t J, size_t I>
+        typename std::enable_if<J < I>::type __skip (const char*& cursor) const
+        {
+            view_traits<typename element<J>::base_t, W>::skip(cursor, m_end);
+            __skip<J + 1, I>(cursor);
+        }
+
+        template <size_t J, size_t I>
+        typename std::enable_if<J == I>::type __skip (const char*&) const {}
+
+        template <size_t J>
+        typename std::enable_if<J < sizeof...(A)>::type __own (tuple_t& result, const char*& cursor) const
+        {
+            typedef view_traits<typename element<J>::base_t, W> traits_t;
+
+            std::get<J>(result) = traits_t::own(traits_t::read(cursor, m_end));
+            __own<J + 1>(result, cursor);
+        }
+
+        template <size_t J>
+        typename std::enable_if<J == sizeof...(A)>::type __own (tuple_t&, const char*&) const {}
+
+        const char* m_data;
+        const char* m_end;
+    };
+
+    template <typename... A>
+    using tuple_view = basic_tuple_view<big_endian_wire, A...>;
+
+    template <size_t I, typename W, typename... A>
+    typename basic_tuple_view<W, A...>::template element<I>::type get (const basic_tuple_view<W, A...>& x)
+    {
+        return x.template get<I>();
+    }
+
+    namespace __view
+    {
+        struct scalar_tag {};
+        struct string_tag {};
+        struct span_tag {};
+        struct sequence_tag {};
+        struct map_tag {};
+        struct indexed_tag {};
+        struct tuple_tag {};
+        struct pair_tag {};
+
+        template <typename T>
+        struct has_mapped_type
+        {
+            template <typename A>
+            static std::true_type test (typename A::mapped_type*);
+
+            template <typename A>
+            static std::false_type test (...);
+
+            typedef decltype(test<T>(nullptr)) type;
+            static const bool value = type::value;
+        };
+
+        template <typename T>
+        struct tag_of
+        {
+            typedef typename std::conditional<std::is_scalar<T>::value, scalar_tag,
+                    typename std::conditional<is_indexed<T>::value, indexed_tag,
+                    typename std::conditional<std::is_same<T, std::string>::value, string_tag,
+                    typename std::conditional<is_bulk_sequence<T, char>::value, span_tag,
+                    typename std::conditional<has_mapped_type<T>::value, map_tag, sequence_tag>::type>::type>::type>::type>::type type;
+        };
+
+        template <typename... A>
+        struct tag_of<std::tuple<A...>>
+        {
+            typedef tuple_tag type;
+        };
+
+        template <typename T1, typename T2>
+        struct tag_of<std::pair<T1, T2>>
+        {
+            typedef pair_tag type;
+        };
+
+        inline const char* require (const char* cursor, const char* end, size_t n)
+        {
+            if (static_cast<size_t>(end - cursor) < n)
+            {
+                throw std::out_of_range("Unexpected end of input.");
+            }
+            return cursor;
+        }
+
+        inline size_t read_length (const char*& cursor, const char* end)
+        {
+            size_t length;
+            cursor = length_binder::decode(cursor, end, length);
+            return length;
+        }
+
+        template <typename T, typename W, typename _Tag = typename tag_of<T>::type>
+        struct traits;
+
+        template <typename T, typename W>
+        struct traits<T, W, scalar_tag>
+        {
+            typedef T type;
+            static const size_t fixed_size = sizeof(T);
+
+            static type read (const char*& cursor, const char* end)
+            {
+                SerializableSequence<T, char> serializer;
+                std::memcpy(serializer.sequence, require(cursor, end, sizeof(T)), sizeof(T));
+                cursor += sizeof(T);
+                if (W::reverse_on_read())
+                {
+                    serializer.reverse();
+                }
+                return serializer.value;
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                cursor = require(cursor, end, sizeof(T)) + sizeof(T);
+            }
+
+            static T own (const type& x)
+            {
+                return x;
+            }
+        };
+
+        template <typename T, typename V>
+        struct contiguous_traits
+        {
+            typedef V type;
+            typedef typename T::value_type value_type;
+            static const size_t fixed_size = 0;
+
+            static type read (const char*& cursor, const char* end)
+            {
+                size_t length = read_length(cursor, end);
+                const char* data = cursor;
+                __advance(cursor, end, length);
+                return type(data, length);
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                __advance(cursor, end, read_length(cursor, end));
+            }
+
+            static T own (const type& x)
+            {
+                return x.own();
+            }
+        private:
+            static void __advance (const char*& cursor, const char* end, size_t length)
+            {
+                if (length > static_cast<size_t>(end - cursor) / sizeof(value_type))
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                cursor += length * sizeof(value_type);
+            }
+        };
+
+        template <typename T, typename W>
+        struct traits<T, W, string_tag> : public contiguous_traits<T, string_view> {};
+
+        template <typename T, typename W>
+        struct traits<T, W, span_tag> : public contiguous_traits<T, scalar_span<T, W>> {};
+
+        template <typename T, typename V, typename W>
+        struct sequence_traits
+        {
+            typedef V type;
+            typedef typename std::remove_cv<typename T::value_type>::type element_t;
+            static const size_t fixed_size = 0;
+
+            static type read (const char*& cursor, const char* end)
+            {
+                size_t length = read_length(cursor, end);
+                const char* data = cursor;
+                __skip_elements(cursor, end, length);
+                return type(data, cursor, length);
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                __skip_elements(cursor, end, read_length(cursor, end));
+            }
+
+            /* Top-level read: variable-size elements are bounded by end and
+             * delimited while iterating, so cursor stays at the first one. */
+            static type open (const char*& cursor, const char* end)
+            {
+                if (view_traits<element_t, W>::fixed_size > 0)
+                {
+                    return read(cursor, end);
+                }
+                size_t length = read_length(cursor, end);
+                return type(cursor, end, length);
+            }
+
+            static T own (const type& x)
+            {
+                return x.own();
+            }
+        private:
+            static void __skip_elements (const char*& cursor, const char* end, size_t length)
+            {
+                const size_t element_size = view_traits<element_t, W>::fixed_size;
+                if (element_size > 0)
+                {
+                    if (length > static_cast<size_t>(end - cursor) / element_size)
+                    {
+                        throw std::out_of_range("Unexpected end of input.");
+                    }
+                    cursor += length * element_size;
+                    return;
+                }
+                while (length-- > 0)
+                {
+                    view_traits<element_t, W>::skip(cursor, end);
+                }
+            }
+        };
+
+        template <typename T, typename W>
+        struct traits<T, W, sequence_tag> : public sequence_traits<T, sequence_view<T, W>, W> {};
+
+        template <typename T, typename W>
+        struct traits<T, W, map_tag> : public sequence_traits<T, map_view<T, W>, W> {};
+
+        template <typename T, typename W>
+        struct traits<T, W, indexed_tag>
+        {
+            typedef typename T::container_type container_t;
+            typedef indexed_view<container_t, W> type;
+            typedef typename type::traits_t element_traits;
+            static const size_t fixed_size = 0;
+
+            static type read (const char*& cursor, const char* end)
+            {
+                size_t block;
+                size_t length;
+                const char* table = __header(cursor, end, block, length);
+                const char* data = cursor;
+                __skip_elements(cursor, end, table, block, length);
+                return type(table, block, data, cursor, length);
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                size_t block;
+                size_t length;
+                const char* table = __header(cursor, end, block, length);
+                __skip_elements(cursor, end, table, block, length);
+            }
+
+            static T own (const type& x)
+            {
+                return T(x.own());
+            }
+        private:
+            /* Leaves cursor at the first element and returns the table. */
+            static const char* __header (const char*& cursor, const char* end, size_t& block, size_t& length)
+            {
+                block = read_length(cursor, end);
+                size_t entries = read_length(cursor, end);
+                if (entries > static_cast<size_t>(end - cursor) / sizeof(uint64_t))
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                const char* table = cursor;
+                cursor += entries * sizeof(uint64_t);
+                length = read_length(cursor, end);
+                if (block == 0 || entries != length / block + (length % block != 0 ? 1 : 0))
+                {
+                    throw std::out_of_range("Offset table does not match the sequence.");
+                }
+                return table;
+            }
+
+            /* Jumps to the last block and parses only what is left of it. */
+            static void __skip_elements (const char*& cursor, const char* end, const char* table, size_t block, size_t length)
+            {
+                if (length == 0)
+                {
+                    return;
+                }
+                const size_t element_size = element_traits::fixed_size;
+                if (element_size > 0)
+                {
+                    if (length > static_cast<size_t>(end - cursor) / element_size)
+                    {
+                        throw std::out_of_range("Unexpected end of input.");
+                    }
+                    cursor += length * element_size;
+                    return;
+                }
+                size_t last = (length - 1) / block;
+                const char* offset = table + last * sizeof(uint64_t);
+                uint64_t position = traits<uint64_t, W>::read(offset, offset + sizeof(uint64_t));
+                if (position > static_cast<uint64_t>(end - cursor))
+                {
+                    throw std::out_of_range("Unexpected end of input.");
+                }
+                cursor += position;
+                for (size_t left = length - last * block; left > 0; --left)
+                {
+                    element_traits::skip(cursor, end);
+                }
+            }
+        };
+
+        template <typename W, typename... A>
+        struct traits<std::tuple<A...>, W, tuple_tag>
+        {
+            typedef basic_tuple_view<W, A...> type;
+            static const size_t fixed_size = fixed_serialized_size<std::tuple<A...>>::value;
+
+            static type read (const char*& cursor, const char* end)
+            {
+                const char* data = cursor;
+                skip(cursor, end);
+                return type(data, end);
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                __skip<0>(cursor, end);
+            }
+
+            static std::tuple<A...> own (const type& x)
+            {
+                return x.own();
+            }
+        private:
+            template <size_t I>
+            static typename std::enable_if<I < sizeof...(A)>::type __skip (const char*& cursor, const char* end)
+            {
+                view_traits<typename std::tuple_element<I, std::tuple<A...>>::type, W>::skip(cursor, end);
+                __skip<I + 1>(cursor, end);
+            }
+
+            template <size_t I>
+            static typename std::enable_if<I == sizeof...(A)>::type __skip (const char*&, const char*) {}
+        };
+
+        template <typename T1, typename T2, typename W>
+        struct traits<std::pair<T1, T2>, W, pair_tag>
+        {
+            typedef pair_view<T1, T2, W> type;
+            typedef typename type::first_t first_t;
+            typedef typename type::second_t second_t;
+            static const size_t fixed_size = fixed_serialized_size<std::pair<first_t, second_t>>::value;
+
+            static type read (const char*& cursor, const char* end)
+            {
+                typename type::first_type first = view_traits<first_t, W>::read(cursor, end);
+                return type(first, view_traits<second_t, W>::read(cursor, end));
+            }
+
+            static void skip (const char*& cursor, const char* end)
+            {
+                view_traits<first_t, W>::skip(cursor, end);
+                view_traits<second_t, W>::skip(cursor, end);
+            }
+
+            static std::pair<first_t, second_t> own (const type& x)
+            {
+                return x.own();
+            }
+        };
+    };
+
+    /* type is the view decoded for a serialized T; read/skip advance a
+     * cursor over [cursor, end) and own materializes a T from a view. */
+    template <typename T, typename W>
+    struct view_traits : public __view::traits<typename std::remove_cv<T>::type, W> {};
+
+    namespace __view
+    {
+        template <typename Tr>
+        auto open (const char*& cursor, const char* end, int) -> decltype(Tr::open(cursor, end))
+        {
+            return Tr::open(cursor, end);
+        }
+
+        template <typename Tr>
+        typename Tr::type open (const char*& cursor, const char* end, long)
+        {
+            return Tr::read(cursor, end);
+        }
+    };
+
+    /* The view of the whole buffer: a sequence of variable-size elements is
+     * opened in constant time and validated as it is iterated. */
+    template <typename T, typename W = big_endian_wire>
+    typename view_traits<T, W>::type view (const char* data, size_t length)
+    {
+        const char* cursor = data;
+        return __view::open<view_traits<T, W>>(cursor, data + length, 0);
+    }
+
+    /* The source is consumed past the value, so its end is found up front. */
+    template <typename T, typename W = big_endian_wire>
+    typename view_traits<T, W>::type view (span_source& source)
+    {
+        const char* first = source.require(0);
+        const char* cursor = first;
+        typename view_traits<T, W>::type result = view_traits<T, W>::read(cursor, first + source.available());
+        source.consume(static_cast<size_t>(cursor - first));
+        return result;
+    }
+
+    template <typename V>
+    auto own (const V& x) -> decltype(x.own())
+    {
+        return x.own();
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_scalar<T>::value, T>::type own (const T& x)
+    {
+        return x;
+    }
+};
+
+#endif	/* VIEW_HPP */
+
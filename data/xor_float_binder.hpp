@@ -0,0 +1,651 @@
+/*
+ * File:   xor_float_binder.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 9:10 PM
+ */
+
+#ifndef XOR_FLOAT_BINDER_HPP
+#define	XOR_FLOAT_BINDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bitset>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "./basic_binder.hpp"
+#include "./byte_order.hpp"
+#include "./sink.hpp"
+#include "./varint.hpp"
+
+namespace data
+{
+    /* Sequences of IEEE float or double. */
+    template <typename T, bool = is_forward_sequence<T>::value>
+    struct is_float_sequence
+    {
+        typedef std::false_type type;
+        static const bool value = type::value;
+    };
+
+    template <typename T>
+    struct is_float_sequence<T, true>
+    {
+        typedef typename std::decay<decltype(*std::begin(std::declval<T&>()))>::type element_t;
+
+        typedef std::integral_constant<bool, (std::is_same<element_t, float>::value || std::is_same<element_t, double>::value) && std::numeric_limits<element_t>::is_iec559> type;
+        static const bool value = type::value;
+    };
+
+    namespace __xor_float
+    {
+        /* Values per block; every block starts over from zero. */
+        static const size_t block_length = 1024;
+        /* Bits of the leading zero count; longer runs are capped. */
+        static const unsigned lead_bits = 5;
+
+        template <typename F>
+        struct traits
+        {
+            typedef typename std::conditional<sizeof(F) == 4, uint32_t, uint64_t>::type word_t;
+
+            static const unsigned bits = 8 * sizeof(F);
+            /* Bits of the meaningful length, stored minus one. */
+            static const unsigned length_bits = sizeof(F) == 4 ? 5 : 6;
+            /* Bits of the header of a new window. */
+            static const unsigned header_bits = lead_bits + length_bits;
+            /* Largest encoded block: a block the coding does not shrink
+             * enough is stored raw. */
+            static const size_t max_block_size = block_length * sizeof(F);
+
+            static word_t cast (F x)
+            {
+                word_t result;
+                std::memcpy(&result, &x, sizeof(result));
+                return result;
+            }
+
+            static F cast (word_t x)
+            {
+                F result;
+                std::memcpy(&result, &x, sizeof(result));
+                return result;
+            }
+        };
+
+        inline unsigned leading (uint64_t x, unsigned bits)
+        {
+            return varint::count_leading_zeros(x) - (64 - bits);
+        }
+
+        inline unsigned trailing (uint64_t x)
+        {
+            return varint::count_trailing_zeros(x);
+        }
+
+        inline uint64_t mask (unsigned n)
+        {
+            return n == 0 ? 0 : ~uint64_t(0) >> (64 - n);
+        }
+
+        /* MSB-first bit stream over a caller-provided buffer. */
+        class bit_writer
+        {
+        public:
+            explicit bit_writer (char* data) : m_data(data), m_cursor(data), m_word(0), m_used(0) {}
+
+            /* Appends the n low bits of x, 1 <= n <= 64. */
+            void put (uint64_t x, unsigned n)
+            {
+                const unsigned free = 64 - m_used;
+                if (n < free)
+                {
+                    m_word = (m_word << n) | x;
+                    m_used += n;
+                    return;
+                }
+                const unsigned rest = n - free;
+                __store((free == 64 ? 0 : m_word << free) | (x >> rest));
+                m_word = x & mask(rest);
+                m_used = rest;
+            }
+
+            /* Pads the last byte with zeros; returns the bytes written. */
+            size_t finish ()
+            {
+                if (m_used > 0)
+                {
+                    const uint64_t word = to_big(m_word << (64 - m_used));
+                    std::memcpy(m_cursor, &word, (m_used + 7) / 8);
+                    m_cursor += (m_used + 7) / 8;
+                    m_used = 0;
+                }
+                return static_cast<size_t>(m_cursor - m_data);
+            }
+        private:
+            void __store (uint64_t x)
+            {
+                x = to_big(x);
+                std::memcpy(m_cursor, &x, sizeof(x));
+                m_cursor += sizeof(x);
+            }
+
+            char* m_data;
+            char* m_cursor;
+            uint64_t m_word;
+            unsigned m_used;
+        };
+
+        /* Reads past the end as zeros. */
+        class bit_reader
+        {
+        public:
+            bit_reader (const char* data, size_t n) : m_data(data), m_length(n), m_limit(n < sizeof(uint64_t) ? 0 : n - sizeof(uint64_t) + 1), m_position(0) {}
+
+            /* At least the next 57 bits, MSB-aligned. */
+            uint64_t peek () const
+            {
+                const size_t offset = m_position / 8;
+                return to_big(offset < m_limit ? __load(offset) : __tail(offset)) << (m_position % 8);
+            }
+
+            void skip (unsigned n)
+            {
+                m_position += n;
+            }
+        private:
+            uint64_t __load (size_t offset) const
+            {
+                uint64_t word;
+                std::memcpy(&word, m_data + offset, sizeof(word));
+                return word;
+            }
+
+            uint64_t __tail (size_t offset) const
+            {
+                uint64_t word = 0;
+                if (offset < m_length)
+                {
+                    std::memcpy(&word, m_data + offset, m_length - offset);
+                }
+                return word;
+            }
+
+            const char* m_data;
+            size_t m_length;
+            /* Offsets below it have a whole word to load. */
+            size_t m_limit;
+            size_t m_position;
+        };
+
+        /* A block that the XOR coding does not shrink by a quarter is
+         * stored as big-endian words, recognized by its byte length: it
+         * decodes at the speed of a copy, a coded value takes several
+         * times longer. */
+        template <typename F>
+        size_t store_block (const F* values, size_t length, char* out)
+        {
+            for (size_t i = 0; i < length; ++i, out += sizeof(F))
+            {
+                const typename traits<F>::word_t word = to_big(traits<F>::cast(values[i]));
+                std::memcpy(out, &word, sizeof(word));
+            }
+            return length * sizeof(F);
+        }
+
+        template <typename F>
+        void load_block (const char* data, F* values, size_t length)
+        {
+            for (size_t i = 0; i < length; ++i, data += sizeof(F))
+            {
+                typename traits<F>::word_t word;
+                std::memcpy(&word, data, sizeof(word));
+                values[i] = traits<F>::cast(to_big(word));
+            }
+        }
+
+        /* Copies a bitmap of n bits, clearing the padding of its last byte
+         * into a zeroed buffer; returns the bits set. */
+        inline size_t load_bitmap (const char* data, size_t n, unsigned char* out)
+        {
+            std::memcpy(out, data, (n + 7) / 8);
+            if (n % 8 != 0)
+            {
+                out[n / 8] &= static_cast<unsigned char>(0xff << (8 - n % 8));
+            }
+            size_t count = 0;
+            for (size_t i = 0; i < (n + 63) / 64; ++i)
+            {
+                uint64_t word;
+                std::memcpy(&word, out + i * sizeof(word), sizeof(word));
+                count += std::bitset<64>(word).count();
+            }
+            return count;
+        }
+
+        /* Gorilla-style coding of each value XORed with the previous one,
+         * as four streams, each padded to a byte:
+         *
+         *   a bit per value, set unless it repeats the previous one
+         *   a bit per changed value, set if it opens a new window
+         *   <lead> <length - 1> of each new window
+         *   the bits of each changed value in its window
+         *
+         * The window is reused unless it is longer than opening a new one
+         * for both this value and the one before it, so that a single
+         * narrow value does not shrink it. */
+        template <typename F>
+        size_t encode_block (const F* values, size_t length, char* out)
+        {
+            typedef traits<F> traits_t;
+            typedef typename traits_t::word_t word_t;
+
+            char changes [block_length / 8];
+            char opens [block_length / 8];
+            char headers [(block_length * traits_t::header_bits + 7) / 8];
+            char payload [block_length * sizeof(F)];
+            bit_writer changed (changes);
+            bit_writer opened (opens);
+            bit_writer windows (headers);
+            bit_writer writer (payload);
+            word_t previous = 0;
+            unsigned window_lead = 0;
+            unsigned window_length = 0;
+            /* Bits of the last XOR, none after a repeat. */
+            unsigned recent_first = traits_t::bits;
+            unsigned recent_last = 0;
+            for (size_t i = 0; i < length; ++i)
+            {
+                const word_t value = traits_t::cast(values[i]);
+                const uint64_t x = value ^ previous;
+                previous = value;
+                changed.put(x != 0, 1);
+                if (x == 0)
+                {
+                    recent_first = traits_t::bits;
+                    recent_last = 0;
+                    continue;
+                }
+                const unsigned lead = std::min(leading(x, traits_t::bits), (1u << lead_bits) - 1);
+                const unsigned last = traits_t::bits - trailing(x);
+                const unsigned span = std::max(last, recent_last) - std::min(lead, recent_first);
+                recent_first = lead;
+                recent_last = last;
+                if (window_length > 0 && lead >= window_lead && last <= window_lead + window_length && window_length <= span + traits_t::header_bits)
+                {
+                    opened.put(0, 1);
+                    writer.put(x >> (traits_t::bits - window_lead - window_length), window_length);
+                    continue;
+                }
+                window_lead = lead;
+                window_length = last - lead;
+                opened.put(1, 1);
+                windows.put((uint64_t(window_lead) << traits_t::length_bits) | (window_length - 1), traits_t::header_bits);
+                writer.put(x >> (traits_t::bits - last), window_length);
+            }
+            const size_t sizes [] = {changed.finish(), opened.finish(), windows.finish(), writer.finish()};
+            if (4 * (sizes[0] + sizes[1] + sizes[2] + sizes[3]) > 3 * length * sizeof(F))
+            {
+                return store_block(values, length, out);
+            }
+            const char* streams [] = {changes, opens, headers, payload};
+            size_t size = 0;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                std::memcpy(out + size, streams[i], sizes[i]);
+                size += sizes[i];
+            }
+            return size;
+        }
+
+        /* The stream sizes follow from the bits set in the bitmaps, and
+         * the windows are expanded up front to the mask of their bits at
+         * the top of a word read at the payload position and the shift
+         * that puts them in place. A repeat is then decoded as a changed
+         * value with an empty window, without a branch; only a new window
+         * takes one. Runs of values that all change within a window narrow
+         * enough for two of them to fit a word are decoded two at a time,
+         * runs of repeats filled.
+         * The payload is read a word at a time until its end is a group of
+         * values away, then from a zero-padded copy of the rest. */
+        template <typename F>
+        void decode_block (const char* data, size_t n, F* values, size_t length)
+        {
+            typedef traits<F> traits_t;
+            typedef typename traits_t::word_t word_t;
+            /* Values between payload bound checks, the bytes they read at
+             * most, and values decoded two at a time or filled as repeats
+             * if they all can be. */
+            static const size_t group = 64;
+            static const size_t reach = group * sizeof(uint64_t) + sizeof(uint64_t) + 1;
+            static const size_t run = 16;
+            struct window_t
+            {
+                uint64_t mask;
+                unsigned shift;
+                unsigned length;
+            };
+
+            if (n == length * sizeof(F))
+            {
+                load_block(data, values, length);
+                return;
+            }
+            unsigned char changes [block_length / 8 + sizeof(uint64_t)] = {};
+            unsigned char opens [block_length / 8 + 2 * sizeof(uint64_t)] = {};
+            size_t offset = (length + 7) / 8;
+            if (offset > n)
+            {
+                throw std::runtime_error("Corrupted float block.");
+            }
+            const size_t changed = load_bitmap(data, length, changes);
+            if (offset + (changed + 7) / 8 > n)
+            {
+                throw std::runtime_error("Corrupted float block.");
+            }
+            const size_t opened = load_bitmap(data + offset, changed, opens);
+            offset += (changed + 7) / 8;
+            const size_t header_size = (opened * traits_t::header_bits + 7) / 8;
+            if ((changed > 0 && (opens[0] & 0x80) == 0) || offset + header_size > n)
+            {
+                throw std::runtime_error("Corrupted float block.");
+            }
+            window_t windows [block_length + 1];
+            windows[0] = window_t {0, 0, 0};
+            bit_reader headers (data + offset, header_size);
+            for (size_t i = 1; i <= opened; ++i)
+            {
+                const uint64_t head = headers.peek();
+                const unsigned lead = static_cast<unsigned>(head >> (64 - lead_bits));
+                const unsigned window_length = static_cast<unsigned>(head >> (64 - traits_t::header_bits) & mask(traits_t::length_bits)) + 1;
+                if (lead + window_length > traits_t::bits)
+                {
+                    throw std::runtime_error("Corrupted float block.");
+                }
+                windows[i] = window_t {~uint64_t(0) << (64 - window_length), 64 - traits_t::bits + lead, window_length};
+                headers.skip(traits_t::header_bits);
+            }
+            offset += header_size;
+
+            const char* payload = data + offset;
+            size_t limit = n - offset;
+            char tail [2 * reach];
+            size_t position = 0;
+            size_t change = 0;
+            const window_t* window = windows;
+            uint64_t window_mask = 0;
+            unsigned window_shift = 0;
+            uint64_t window_length = 0;
+            /* Whether the window can take more bits than a word read. */
+            bool wide = false;
+            word_t previous = 0;
+            for (size_t first = 0; first < length; first += group)
+            {
+                if (payload != tail && position / 8 + reach > limit)
+                {
+                    const size_t start = position / 8;
+                    std::memset(tail, 0, sizeof(tail));
+                    std::memcpy(tail, payload + start, limit - start);
+                    payload = tail;
+                    limit -= start;
+                    position -= 8 * start;
+                }
+                uint64_t steps;
+                std::memcpy(&steps, changes + first / 8, sizeof(steps));
+                steps = to_big(steps);
+                uint64_t opening;
+                std::memcpy(&opening, opens + change / 8, sizeof(opening));
+                opening = to_big(opening) << (change % 8) | uint64_t(opens[change / 8 + sizeof(opening)]) >> (8 - change % 8);
+                change += std::bitset<64>(steps).count();
+                for (size_t i = first, last = std::min(first + group, length); i < last; )
+                {
+                    if (2 * window_length <= 57 && (steps >> (64 - run)) == mask(run) && (opening >> (64 - run)) == 0 && i + run <= last)
+                    {
+                        for (const size_t end = i + run; i < end; i += 2)
+                        {
+                            uint64_t word;
+                            std::memcpy(&word, payload + position / 8, sizeof(word));
+                            word = to_big(word) << (position % 8);
+                            previous ^= static_cast<word_t>((word & window_mask) >> window_shift);
+                            values[i] = traits_t::cast(previous);
+                            previous ^= static_cast<word_t>((word << window_length & window_mask) >> window_shift);
+                            values[i + 1] = traits_t::cast(previous);
+                            position += 2 * window_length;
+                        }
+                        steps <<= run;
+                        opening <<= run;
+                        continue;
+                    }
+                    if ((steps >> (64 - run)) == 0 && i + run <= last)
+                    {
+                        std::fill(values + i, values + i + run, traits_t::cast(previous));
+                        i += run;
+                        steps <<= run;
+                        continue;
+                    }
+                    for (const size_t end = std::min(i + run, last); i < end; ++i)
+                    {
+                        /* All ones for a changed value, else zero. */
+                        const uint64_t step = 0 - (steps >> 63);
+                        steps += steps;
+                        const uint64_t open = opening & step;
+                        opening += open;
+                        if (open >> 63)
+                        {
+                            ++window;
+                            window_mask = window->mask;
+                            window_shift = window->shift;
+                            window_length = window->length;
+                            wide = window_length > 57;
+                        }
+                        const size_t at = position / 8;
+                        const unsigned shift = position % 8;
+                        uint64_t word;
+                        std::memcpy(&word, payload + at, sizeof(word));
+                        word = to_big(word) << shift;
+                        if (wide)
+                        {
+                            word |= uint64_t(static_cast<unsigned char>(payload[at + sizeof(word)])) >> (8 - shift);
+                        }
+                        previous ^= static_cast<word_t>((word & window_mask & step) >> window_shift);
+                        position += window_length & step;
+                        values[i] = traits_t::cast(previous);
+                    }
+                }
+                if (position > 8 * limit)
+                {
+                    throw std::runtime_error("Corrupted float block.");
+                }
+            }
+        }
+    };
+
+    /* Float and double sequences XOR-coded in the style of Gorilla: slowly
+     * changing series keep only the few bits that differ from the previous
+     * value, repeats take a single bit. Layout:
+     *
+     *   element count, then per block of 1024 values: byte length
+     *   (varint), the bit streams of encode_block, or the raw big-endian
+     *   values when the bit streams would not save a quarter of them
+     *
+     * Values round-trip bit for bit, NaN payloads included. Opt in by
+     * listing it before sequence_binder, see packing_binder. */
+    struct xor_float_binder
+    {
+        template <typename S, typename T, typename Cb>
+        typename std::enable_if<is_output<S>::value && is_float_sequence<T>::value && sizeof(typename S::char_type) == 1, S&>::type
+        operator() (S& stream, T&& x, Cb&& callback) const
+        {
+            typedef typename is_float_sequence<T>::element_t element_t;
+
+            length_type length {__count(x, 0)};
+            callback(stream, length);
+            element_t values [__xor_float::block_length];
+            char block [__xor_float::traits<element_t>::max_block_size];
+            auto iter = std::begin(x);
+            for (size_t left = length.value, step; left > 0; left -= step)
+            {
+                step = std::min(left, __xor_float::block_length);
+                for (size_t i = 0; i < step; ++i, ++iter)
+                {
+                    values[i] = *iter;
+                }
+                length_type size {__xor_float::encode_block(values, step, block)};
+                callback(stream, size);
+                stream.write(block, size.value);
+            }
+            return stream;
+        }
+
+        template <typename T, typename S, typename Cb>
+        typename std::enable_if<is_input<S>::value && is_float_sequence<T>::value && sizeof(typename S::char_type) == 1, T&>::type
+        operator() (T& x, S& stream, Cb&& callback) const
+        {
+            typedef typename std::decay<T>::type type_t;
+            typedef typename is_float_sequence<T>::element_t element_t;
+
+            length_type length {};
+            callback(length, stream);
+            type_t& target = const_cast<type_t&>(x);
+            target.clear();
+            __reserve(target, __capacity(length.value, stream), 0);
+            element_t values [__xor_float::block_length];
+            char block [__xor_float::traits<element_t>::max_block_size];
+            for (size_t left = length.value, step; left > 0 && __good(stream); left -= step)
+            {
+                length_type size {};
+                callback(size, stream);
+                if (size.value > sizeof(block))
+                {
+                    throw std::runtime_error("Corrupted float block.");
+                }
+                step = std::min(left, __xor_float::block_length);
+                element_t* first = __window(target, step, values, 0);
+                const bool done = __decode(stream, block, size.value, first, step);
+                __settle(target, first, first + step, done, 0);
+                if (!done)
+                {
+                    break;
+                }
+            }
+            return x;
+        }
+    private:
+        template <typename C>
+        static auto __count (const C& x, int) -> decltype(static_cast<size_t>(x.size()))
+        {
+            return static_cast<size_t>(x.size());
+        }
+
+        template <typename C>
+        static size_t __count (const C& x, long)
+        {
+            return static_cast<size_t>(std::distance(std::begin(x), std::end(x)));
+        }
+
+        template <typename C>
+        static auto __reserve (C& target, size_t length, int) -> decltype(target.reserve(length), void())
+        {
+            target.reserve(length);
+        }
+
+        template <typename C>
+        static void __reserve (C&, size_t, long) {}
+
+        /* The count is untrusted: a value takes at least a bit of the
+         * source, and a stream is reserved for one block at a time. */
+        static size_t __capacity (size_t length, const basic_source& source)
+        {
+            return std::min(length, std::max(__xor_float::block_length, 8 * source.available()));
+        }
+
+        template <typename _Ttr>
+        static size_t __capacity (size_t length, const std::basic_istream<char, _Ttr>&)
+        {
+            return std::min(length, __xor_float::block_length);
+        }
+
+        /* Vectors are decoded straight into their storage, anything else
+         * through the block buffer. */
+        template <typename C, typename F>
+        static auto __window (C& target, size_t n, F*, int) -> decltype(target.data())
+        {
+            const size_t size = target.size();
+            target.resize(size + n);
+            return target.data() + size;
+        }
+
+        template <typename C, typename F>
+        static F* __window (C&, size_t, F* buffer, long)
+        {
+            return buffer;
+        }
+
+        template <typename C, typename F>
+        static auto __settle (C& target, F* first, F* last, bool done, int) -> decltype(target.data(), void())
+        {
+            if (!done)
+            {
+                target.resize(target.size() - static_cast<size_t>(last - first));
+            }
+        }
+
+        template <typename C, typename F>
+        static void __settle (C& target, F* first, F* last, bool done, long)
+        {
+            for (; done && first != last; ++first)
+            {
+                target.insert(target.end(), *first);
+            }
+        }
+
+        template <typename _Ttr, typename F>
+        static bool __decode (std::basic_istream<char, _Ttr>& stream, char* block, size_t n, F* values, size_t length)
+        {
+            if (!stream.read(block, static_cast<std::streamsize>(n)))
+            {
+                return false;
+            }
+            __xor_float::decode_block(block, n, values, length);
+            return true;
+        }
+
+        /* Decoded in place from the source window. */
+        template <typename F>
+        static bool __decode (basic_source& source, char*, size_t n, F* values, size_t length)
+        {
+            __xor_float::decode_block(source.require(n), n, values, length);
+            source.consume(n);
+            return true;
+        }
+
+        template <typename _Ttr>
+        static bool __good (const std::basic_istream<char, _Ttr>& stream)
+        {
+            return !stream.fail();
+        }
+
+        static bool __good (const basic_source&)
+        {
+            return true;
+        }
+    };
+
+    template <>
+    struct binder_name<xor_float_binder>
+    {
+        static const char* value ()
+        {
+            return "xor_float";
+        }
+    };
+};
+
+#endif	/* XOR_FLOAT_BINDER_HPP */
+
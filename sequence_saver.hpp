@@ -0,0 +1,1089 @@
+/*
+ * File:   sequence_saver.hpp
+ * Author: Konstantin
+ *
+ * Created on October 18, 2026, 11:55 PM
+ */
+
+#ifndef SEQUENCE_SAVER_HPP
+#define	SEQUENCE_SAVER_HPP
+
+#include <iostream>
+#include <type_traits>
+#include <tuple>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include "./data/byte_order.hpp"
+#include "./data/serialization.hpp"
+
+/* Typed record format of sox: SequenceSaver writes [type id][value] records
+ * described by a per-stream schema, SequenceLoader reads them back through
+ * compiled decode plans. */
+
+template <typename T>
+struct is_forward_sequence
+{
+    template <typename A>
+    static std::true_type test (decltype(std::begin(std::declval<A>()))*, decltype(std::end(std::declval<A>()))*);
+    
+    template <typename A>
+    static std::false_type test (...);
+    
+    typedef decltype(test<T>(nullptr, nullptr)) type;
+    static const bool value = type::value;
+};
+
+template <typename T>
+struct is_tuple
+{
+    typedef std::false_type type;
+    static const bool value = type::value;
+};
+
+template <typename... _Ty>
+struct is_tuple<std::tuple<_Ty...>>
+{
+    typedef std::true_type type;
+    static const bool value = type::value;
+};
+
+template <typename... _Ty>
+struct is_tuple<std::pair<_Ty...>>
+{
+    typedef std::true_type type;
+    static const bool value = type::value;
+};
+
+struct SingleSaver
+{
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<std::is_trivial<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type operator() (std::basic_ostream<_Tch, _Ttr>& stream, const T& x)
+    {
+        data::SerializableSequence<T, _Tch> serializer;
+        serializer.value = x;
+        serializer.serialize();
+        return stream.write(serializer.sequence, serializer.length); 
+    }
+};
+
+struct SingleLoader
+{
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<std::is_trivial<T>::value, std::basic_istream<_Tch, _Ttr>&>::type operator() (std::basic_istream<_Tch, _Ttr>& stream, T& x)
+    {
+        data::SerializableSequence<T, _Tch> serializer;
+        if (stream.read(serializer.sequence, serializer.length))
+        {
+            serializer.serialize();
+            x = serializer.value;
+        }
+        return stream;
+    }
+};
+
+/* Structural type identity computed at compile time: a type hashes the way
+ * SequenceSaver writes it (sequence of an element, tuple of fields, or a
+ * regular value of a given size and kind), so it does not depend on the
+ * compiler's name mangling. */
+struct TypeHash
+{
+    typedef uint64_t hash_t;
+
+    enum Kind : uint8_t {Regular, Sequence, Tuple};
+
+    static constexpr hash_t basis = 14695981039346656037ull;
+    static constexpr hash_t prime = 1099511628211ull;
+
+    static constexpr hash_t mix (hash_t hash, hash_t x)
+    {
+        return (hash ^ x) * prime;
+    }
+
+    template <typename T>
+    static constexpr hash_t scalar ()
+    {
+        return std::is_floating_point<T>::value ? 3 : std::is_signed<T>::value ? 1 : std::is_unsigned<T>::value ? 2 : 0;
+    }
+};
+
+template <typename T, typename = void>
+struct type_hash
+{
+    static constexpr TypeHash::hash_t value = TypeHash::mix(TypeHash::mix(TypeHash::mix(TypeHash::basis, TypeHash::Regular), sizeof(T)), TypeHash::scalar<T>());
+};
+
+template <typename T>
+struct type_hash<T, typename std::enable_if<is_forward_sequence<T>::value>::type>
+{
+    typedef typename std::decay<decltype(*std::begin(std::declval<const T&>()))>::type element_t;
+
+    static constexpr TypeHash::hash_t value = TypeHash::mix(TypeHash::mix(TypeHash::basis, TypeHash::Sequence), type_hash<element_t>::value);
+};
+
+template <typename T, size_t I = 0, bool = (I < std::tuple_size<T>::value)>
+struct tuple_hash
+{
+    typedef typename std::decay<typename std::tuple_element<I, T>::type>::type field_t;
+
+    static constexpr TypeHash::hash_t fold (TypeHash::hash_t hash)
+    {
+        return tuple_hash<T, I + 1>::fold(TypeHash::mix(hash, type_hash<field_t>::value));
+    }
+};
+
+template <typename T, size_t I>
+struct tuple_hash<T, I, false>
+{
+    static constexpr TypeHash::hash_t fold (TypeHash::hash_t hash)
+    {
+        return hash;
+    }
+};
+
+template <typename T>
+struct type_hash<T, typename std::enable_if<is_tuple<T>::value>::type>
+{
+    static constexpr TypeHash::hash_t value = tuple_hash<T>::fold(TypeHash::mix(TypeHash::mix(TypeHash::basis, TypeHash::Tuple), std::tuple_size<T>::value));
+};
+
+template <typename T, typename U>
+constexpr TypeHash::hash_t type_hash<T, U>::value;
+
+template <typename T>
+constexpr TypeHash::hash_t type_hash<T, typename std::enable_if<is_forward_sequence<T>::value>::type>::value;
+
+template <typename T>
+constexpr TypeHash::hash_t type_hash<T, typename std::enable_if<is_tuple<T>::value>::type>::value;
+
+/* Dense process-wide index of every type that has been saved, used as a
+ * direct slot into per-stream tables instead of a map lookup. */
+struct TypeIndex
+{
+    template <typename T>
+    static size_t of ()
+    {
+        static const size_t index = next();
+        return index;
+    }
+private:
+    static size_t next ()
+    {
+        static std::atomic<size_t> counter (0);
+        return counter++;
+    }
+};
+
+template <typename _Lt, typename _H>
+struct TypeInfo
+{
+    typedef _Lt length_t;
+    typedef _H hash_t;
+    
+    TypeInfo() : type(), size(), m_embedded_types() {}
+    
+    enum class StoredType : uint8_t {Regular, Sequence, Tuple};
+    
+    StoredType type;
+    length_t size;
+    std::vector<hash_t> m_embedded_types;
+};
+
+/* Writes records of the form [type id][value]. A type is described once per
+ * stream: the first record of a type is preceded by a schema entry, i.e. id 0,
+ * the structural hash and the TypeInfo of the type, which receives the next
+ * id (starting from 1). Embedded types are described before the types that
+ * contain them. A saver is bound to one stream at a time; reset() forgets
+ * the schema to start another. */
+template <typename _Ss, typename _Mp>
+struct SequenceSaver
+{
+    typedef _Ss single_saver_t;
+    typedef _Mp meta_provider_t;
+    typedef typename meta_provider_t::id_t id_t;
+    typedef typename meta_provider_t::type_info_t type_info_t;
+
+    template <typename T, typename _Tch, typename _Ttr>
+    std::basic_ostream<_Tch, _Ttr>& operator()(std::basic_ostream<_Tch, _Ttr>& stream, const T& x)
+    {
+        save_silent(stream, define<T>(stream));
+        return save(stream, x);
+    }
+    
+    void reset ()
+    {
+        m_meta_provider.reset();
+    }
+    
+protected:
+    template <typename T, typename _Tch, typename _Ttr>
+    id_t define (std::basic_ostream<_Tch, _Ttr>& stream)
+    {
+        return m_meta_provider.template id<T>([this, &stream] (typename meta_provider_t::hash_t hash, const type_info_t& info)
+        {
+            save_silent(stream, id_t(0));
+            save_silent(stream, hash);
+            save_info(stream, info);
+        });
+    }
+    
+    template <typename _Tch, typename _Ttr>
+    std::basic_ostream<_Tch, _Ttr>& save_info (std::basic_ostream<_Tch, _Ttr>& stream, const type_info_t& info)
+    {
+        save_silent(stream, static_cast<typename std::underlying_type<decltype(info.type)>::type>(info.type));
+        if (info.type == type_info_t::StoredType::Regular || info.type == type_info_t::StoredType::Tuple)
+        {
+            save_silent(stream, info.size);
+        }
+        return save_silent(stream, info.m_embedded_types);
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<is_forward_sequence<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type save_silent (std::basic_ostream<_Tch, _Ttr>& stream, const T& seq)
+    {
+        for (auto iter = std::begin(seq); iter != std::end(seq); ++iter)
+        {
+            save(stream, *iter);
+        }
+        return stream;
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<is_forward_sequence<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type save (std::basic_ostream<_Tch, _Ttr>& stream, const T& seq)
+    {
+        save_silent(stream, m_meta_provider.length(seq));
+        return save_silent(stream, seq);
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<is_tuple<T>::value, std::basic_ostream<_Tch, _Ttr>&>::type save (std::basic_ostream<_Tch, _Ttr>& stream, const T& x)
+    {
+        return save_silent(stream, x);
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr, size_t I = 0>
+    typename std::enable_if<is_tuple<T>::value && (I < std::tuple_size<T>::value), std::basic_ostream<_Tch, _Ttr>&>::type save_silent (std::basic_ostream<_Tch, _Ttr>& stream, const T& tpl)
+    {
+        save(stream, std::get<I>(tpl));
+        return save_silent<T, _Tch, _Ttr, I + 1>(stream, tpl);
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr, size_t I = 0>
+    typename std::enable_if<is_tuple<T>::value && (I >= std::tuple_size<T>::value), std::basic_ostream<_Tch, _Ttr>&>::type save_silent (std::basic_ostream<_Tch, _Ttr>& stream, const T& tpl)
+    {
+        return stream;
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<!(is_forward_sequence<T>::value || is_tuple<T>::value), std::basic_ostream<_Tch, _Ttr>&>::type save (std::basic_ostream<_Tch, _Ttr>& stream, const T& x)
+    {
+        return save_silent(stream, x);
+    }
+    
+    template <typename T, typename _Tch, typename _Ttr>
+    typename std::enable_if<!(is_forward_sequence<T>::value || is_tuple<T>::value), std::basic_ostream<_Tch, _Ttr>&>::type save_silent (std::basic_ostream<_Tch, _Ttr>& stream, const T& x)
+    {
+        m_single_saver(stream, x);
+        return stream;
+    }
+protected:
+    single_saver_t m_single_saver;
+    meta_provider_t m_meta_provider;
+};
+
+template <typename _Ss, typename _Mp, typename _Lt, typename _Idt>
+struct TypeInfoSaver : protected SequenceSaver<_Ss, _Mp>
+{
+    typedef _Ss single_saver_t;
+    typedef _Mp metadata_provider_t;
+    typedef SequenceSaver<_Ss, _Mp> sequence_saver_t;
+    typedef TypeInfo<_Lt, _Idt> type_info_t;
+    
+    template <typename _Tch, typename _Ttr>
+    std::basic_ostream<_Tch, _Ttr>& operator() (std::basic_ostream<_Tch, _Ttr>& stream, const type_info_t& info)
+    {
+        return sequence_saver_t::save_info(stream, info);
+    }
+    
+    /* The number of embedded types follows from the stored type: one
+     * element for a sequence, size fields for a tuple, none otherwise. */
+    template <typename _Tch, typename _Ttr>
+    std::basic_istream<_Tch, _Ttr>& operator() (std::basic_istream<_Tch, _Ttr>& stream, type_info_t& info)
+    {
+        typename std::underlying_type<typename type_info_t::StoredType>::type type (0);
+        m_single_loader(stream, type);
+        info = type_info_t();
+        info.type = static_cast<typename type_info_t::StoredType>(type);
+        size_t embedded = 0;
+        switch (info.type)
+        {
+            case type_info_t::StoredType::Regular:
+                m_single_loader(stream, info.size);
+                break;
+            case type_info_t::StoredType::Tuple:
+                m_single_loader(stream, info.size);
+                embedded = static_cast<size_t>(info.size);
+                break;
+            case type_info_t::StoredType::Sequence:
+                embedded = 1;
+                break;
+            default:
+                stream.setstate(std::ios_base::failbit);
+                return stream;
+        }
+        for (_Idt id (0); embedded > 0 && stream; --embedded)
+        {
+            m_single_loader(stream, id);
+            info.m_embedded_types.push_back(id);
+        }
+        return stream;
+    }
+protected:
+    SingleLoader m_single_loader;
+};
+
+template <typename K, typename H = std::hash<K>>
+struct HashKey
+{
+    typedef K key_t;
+    typedef H hasher_t;
+    typedef decltype(std::declval<H>()(std::declval<K>())) hash_t;
+    
+    HashKey() : m_key(), m_hasher(), m_hash() {}
+    HashKey(const key_t& key) : m_key(key), m_hasher(), m_hash(m_hasher(m_key)) {}
+    HashKey(const key_t& key, const hasher_t& hasher) : m_key(key), m_hasher(hasher), m_hash(m_hasher(m_key)) {}
+    HashKey(const hash_t& hash) : m_key(), m_hasher(), m_hash(hash) {}
+    HashKey(const hash_t& hash, const hasher_t& hasher) : m_key(), m_hasher(hasher), m_hash(hash) {}
+    ~HashKey() {}
+    
+    void key(const key_t& x)
+    {
+        m_key = x;
+        if (m_hasher)
+        {
+            m_hash = m_hasher(m_key);
+        }
+    }
+    
+    const key_t& key() const
+    {
+        return m_key;
+    }
+    
+    void hasher(const hasher_t& x)
+    {
+        m_hasher = x;
+        if (m_key)
+        {
+            m_hash = m_hasher(m_key);
+        }
+    }
+    
+    const hasher_t& hasher() const
+    {
+        return m_hasher;
+    }
+    
+    void hash(const hash_t& x)
+    {
+        m_hash = x;
+        if (m_key)
+        {
+            m_key = key_t();
+        }
+    }
+    
+    const hash_t& hash() const
+    {
+        return m_hash;
+    }
+    
+    operator hash_t () const
+    {
+        return m_hash;
+    }
+    
+    operator key_t () const
+    {
+        return m_key;
+    }
+    
+protected:
+    key_t m_key;
+    hasher_t m_hasher;
+    hash_t m_hash;
+};
+
+template <typename T>
+bool operator< (const HashKey<T>& lhs, const HashKey<T>& rhs)
+{
+    return (lhs.hash() < rhs.hash());
+}
+
+/* Per-stream schema: assigns ids to types in the order they are first saved
+ * and keeps their descriptions. The id of a type already described is a
+ * direct slot lookup by TypeIndex; hashes are compile-time constants. */
+template <typename _H, typename _Lt, typename _Idt = _Lt>
+struct TypeInfoProvider
+{
+    typedef _H hash_t;
+    typedef _Lt length_t;
+    typedef _Idt id_t;
+    typedef TypeInfo<length_t, id_t> type_info_t;
+    
+    template <typename T>
+    static constexpr hash_t hash ()
+    {
+        return hash_t (type_hash<T>::value);
+    }
+    
+    /* Id of T on this stream. On first use the embedded types are described
+     * first, then define(hash, info) is called for T itself. */
+    template <typename T, typename F>
+    id_t id (F&& define)
+    {
+        const size_t index = TypeIndex::of<T>();
+        if (index < m_ids.size() && m_ids[index] != 0)
+        {
+            return m_ids[index];
+        }
+        type_info_t info (describe<T>(define));
+        if (m_info.size() >= static_cast<size_t>(std::numeric_limits<id_t>::max()))
+        {
+            throw std::overflow_error("Too many types in one stream.");
+        }
+        m_info.push_back(info);
+        m_hashes.push_back(hash<T>());
+        if (index >= m_ids.size())
+        {
+            m_ids.resize(index + 1, 0);
+        }
+        m_ids[index] = static_cast<id_t>(m_info.size());
+        define(m_hashes.back(), info);
+        return m_ids[index];
+    }
+    
+    template <typename T>
+    typename std::enable_if<is_forward_sequence<T>::value, length_t>::type length (const T& x)
+    {
+        length_t length (0);
+        for (auto iter = std::begin(x); iter != std::end(x); ++iter, ++length);
+        return length;
+    }
+    
+    const type_info_t& operator() (id_t id) const
+    {
+        if (id == 0 || id > m_info.size())
+        {
+            throw std::out_of_range("Info on the requested type is unavailable.");
+        }
+        return m_info[id - 1];
+    }
+    
+    /* Registers a type read from a stream under the next id. */
+    id_t emplace (hash_t hash, const type_info_t& info)
+    {
+        if (m_info.size() >= static_cast<size_t>(std::numeric_limits<id_t>::max()))
+        {
+            throw std::overflow_error("Too many types in one stream.");
+        }
+        m_info.push_back(info);
+        m_hashes.push_back(hash);
+        return static_cast<id_t>(m_info.size());
+    }
+    
+    hash_t hash (id_t id) const
+    {
+        operator()(id);
+        return m_hashes[id - 1];
+    }
+    
+    size_t size () const
+    {
+        return m_info.size();
+    }
+    
+    void reset ()
+    {
+        m_ids.clear();
+        m_info.clear();
+        m_hashes.clear();
+    }
+    
+protected:
+    std::vector<id_t> m_ids;
+    std::vector<type_info_t> m_info;
+    std::vector<hash_t> m_hashes;
+private:
+    template <typename T, typename F>
+    typename std::enable_if<is_forward_sequence<T>::value, type_info_t>::type describe (F& define)
+    {
+        typedef typename std::decay<decltype(*std::begin(std::declval<const T&>()))>::type element_t;
+        
+        type_info_t info;
+        info.type = type_info_t::StoredType::Sequence;
+        info.size = 0;
+        info.m_embedded_types.emplace_back(id<element_t>(define));
+        return info;
+    }
+    
+    template <typename T, typename F>
+    typename std::enable_if<is_tuple<T>::value, type_info_t>::type describe (F& define)
+    {
+        type_info_t info;
+        info.type = type_info_t::StoredType::Tuple;
+        info.size = std::tuple_size<T>::value;
+        describe_fields<T>(info, define);
+        return info;
+    }
+    
+    template <typename T, typename F>
+    typename std::enable_if<!(is_forward_sequence<T>::value || is_tuple<T>::value), type_info_t>::type describe (F&)
+    {
+        type_info_t info;
+        info.type = type_info_t::StoredType::Regular;
+        info.size = sizeof(T);
+        return info;
+    }
+    
+    template <typename T, size_t I = 0, typename F>
+    typename std::enable_if<(I < std::tuple_size<T>::value), void>::type describe_fields (type_info_t& info, F& define)
+    {
+        info.m_embedded_types.emplace_back(id<typename std::decay<typename std::tuple_element<I, T>::type>::type>(define));
+        describe_fields<T, I + 1>(info, define);
+    }
+    
+    template <typename T, size_t I = 0, typename F>
+    typename std::enable_if<(I == std::tuple_size<T>::value), void>::type describe_fields (type_info_t&, F&) {}
+};
+
+/* Flat decode plan for one stored type, compiled once from its schema.
+ * Nodes of the type tree are numbered in preorder (a sequence, then its
+ * element; a tuple, then its fields) and the plan hands the selected ones
+ * to a visitor:
+ *
+ *   begin(field, length) / end(field)      around the elements of a sequence
+ *   value(field, data, size)               a regular value in host order
+ *   values(field, data, count, size)       the elements of a regular sequence
+ *
+ * Selecting a node selects everything below it; unselected parts are
+ * skipped, runs of fixed-size parts with a single ignore(). Adjacent
+ * fixed-size operations are read with a single read() per record or
+ * element. */
+template <typename _Mp>
+struct DecodePlan
+{
+    typedef _Mp meta_provider_t;
+    typedef typename meta_provider_t::id_t id_t;
+    typedef typename meta_provider_t::length_t length_t;
+    typedef typename meta_provider_t::type_info_t type_info_t;
+    
+    struct Op
+    {
+        enum Code : uint8_t {Value, Skip, Array, SkipArray, Loop, End};
+        
+        Code code;
+        bool emit;
+        size_t field;
+        size_t size;
+        /* Loop: index past its End. Head of a fixed run: ops in the run. */
+        size_t next;
+        /* Head of a fixed run: bytes in the run. */
+        size_t run;
+    };
+    
+    static const size_t max_fields = 1 << 20;
+    static const size_t max_size = 1 << 30;
+    
+    DecodePlan() : m_ops(), m_buffer(), m_counts(), m_sizes() {}
+    
+    /* Plan for the type id of provider; no fields means all of them. Types
+     * may only embed types with smaller ids, as the schema defines them. */
+    DecodePlan(const meta_provider_t& provider, id_t id, const std::vector<size_t>& fields = std::vector<size_t>()) : m_ops(), m_buffer(), m_counts(id + 1, 0), m_sizes(id + 1, 0)
+    {
+        for (id_t i = 1; i <= id; ++i)
+        {
+            measure(provider, i);
+        }
+        std::vector<bool> chosen (m_counts[id], fields.empty());
+        for (size_t field : fields)
+        {
+            if (field < chosen.size())
+            {
+                chosen[field] = true;
+            }
+        }
+        size_t field = 0;
+        compile(provider, id, chosen, field, false);
+        merge();
+        m_counts.clear();
+        m_sizes.clear();
+    }
+    
+    const std::vector<Op>& ops () const
+    {
+        return m_ops;
+    }
+    
+    template <typename V, typename _Tch, typename _Ttr>
+    std::basic_istream<_Tch, _Ttr>& operator() (std::basic_istream<_Tch, _Ttr>& stream, V& visitor)
+    {
+        struct Frame
+        {
+            size_t op;
+            length_t left;
+        };
+        
+        std::vector<Frame> stack;
+        for (size_t pc = 0; pc < m_ops.size() && stream; )
+        {
+            const Op& op = m_ops[pc];
+            switch (op.code)
+            {
+                case Op::Value:
+                case Op::Skip:
+                    pc = fixed(stream, pc, visitor);
+                    break;
+                case Op::Array:
+                case Op::SkipArray:
+                {
+                    length_t length = read_length(stream);
+                    if (length > std::numeric_limits<size_t>::max() / op.size)
+                    {
+                        stream.setstate(std::ios_base::failbit);
+                    }
+                    else if (op.code == Op::SkipArray)
+                    {
+                        stream.ignore(static_cast<std::streamsize>(length * op.size));
+                    }
+                    else if (read(stream, static_cast<size_t>(length * op.size)))
+                    {
+                        swap(&m_buffer[0], static_cast<size_t>(length), op.size);
+                        visitor.begin(op.field, static_cast<size_t>(length));
+                        visitor.values(op.field + 1, m_buffer.data(), static_cast<size_t>(length), op.size);
+                        visitor.end(op.field);
+                    }
+                    ++pc;
+                    break;
+                }
+                case Op::Loop:
+                {
+                    length_t length = read_length(stream);
+                    if (!stream)
+                    {
+                        break;
+                    }
+                    if (op.emit)
+                    {
+                        visitor.begin(op.field, static_cast<size_t>(length));
+                    }
+                    if (length == 0 || op.next == pc + 2)
+                    {
+                        if (op.emit)
+                        {
+                            visitor.end(op.field);
+                        }
+                        pc = op.next;
+                    }
+                    else
+                    {
+                        stack.push_back(Frame {pc, length});
+                        ++pc;
+                    }
+                    break;
+                }
+                case Op::End:
+                {
+                    Frame& frame = stack.back();
+                    if (--frame.left > 0)
+                    {
+                        pc = frame.op + 1;
+                    }
+                    else
+                    {
+                        if (m_ops[frame.op].emit)
+                        {
+                            visitor.end(op.field);
+                        }
+                        stack.pop_back();
+                        ++pc;
+                    }
+                    break;
+                }
+            }
+        }
+        return stream;
+    }
+private:
+    /* Nodes in the type tree of id and its stored bytes (0 when they
+     * depend on the value), from those of the types it embeds. */
+    void measure (const meta_provider_t& provider, id_t id)
+    {
+        const type_info_t& info = provider(id);
+        if (info.type == type_info_t::StoredType::Regular && info.size == 0)
+        {
+            throw std::runtime_error("Corrupted schema.");
+        }
+        size_t count = 1;
+        size_t size = info.type == type_info_t::StoredType::Regular ? static_cast<size_t>(info.size) : 0;
+        bool fixed = info.type != type_info_t::StoredType::Sequence;
+        for (id_t embedded : info.m_embedded_types)
+        {
+            if (embedded == 0 || embedded >= id)
+            {
+                throw std::runtime_error("Corrupted schema.");
+            }
+            count += m_counts[embedded];
+            size += m_sizes[embedded];
+            fixed = fixed && m_sizes[embedded] > 0;
+        }
+        if (count > max_fields || size > max_size)
+        {
+            throw std::runtime_error("Corrupted schema.");
+        }
+        m_counts[id] = count;
+        m_sizes[id] = fixed ? size : 0;
+    }
+    
+    void compile (const meta_provider_t& provider, id_t id, const std::vector<bool>& chosen, size_t& field, bool whole)
+    {
+        const type_info_t& info = provider(id);
+        const size_t self = field;
+        const size_t last = self + m_counts[id];
+        whole = whole || chosen[self];
+        const bool needed = whole || std::find(chosen.begin() + self, chosen.begin() + last, true) != chosen.begin() + last;
+        if (!needed)
+        {
+            skip(provider, id);
+            field = last;
+            return;
+        }
+        ++field;
+        if (info.type == type_info_t::StoredType::Regular)
+        {
+            push(Op {Op::Value, true, self, static_cast<size_t>(info.size), 0, 0});
+        }
+        else if (info.type == type_info_t::StoredType::Tuple)
+        {
+            for (id_t embedded : info.m_embedded_types)
+            {
+                compile(provider, embedded, chosen, field, whole);
+            }
+        }
+        else
+        {
+            const type_info_t& element = provider(info.m_embedded_types.front());
+            if (element.type == type_info_t::StoredType::Regular && (whole || chosen[self + 1]))
+            {
+                push(Op {Op::Array, true, self, static_cast<size_t>(element.size), 0, 0});
+                field = last;
+                return;
+            }
+            size_t loop = m_ops.size();
+            push(Op {Op::Loop, true, self, 0, 0, 0});
+            compile(provider, info.m_embedded_types.front(), chosen, field, whole);
+            push(Op {Op::End, true, self, 0, 0, 0});
+            m_ops[loop].next = m_ops.size();
+        }
+    }
+    
+    void skip (const meta_provider_t& provider, id_t id)
+    {
+        const type_info_t& info = provider(id);
+        size_t size = m_sizes[id];
+        if (size > 0)
+        {
+            push(Op {Op::Skip, false, 0, size, 0, 0});
+        }
+        else if (info.type == type_info_t::StoredType::Tuple)
+        {
+            for (id_t embedded : info.m_embedded_types)
+            {
+                skip(provider, embedded);
+            }
+        }
+        else if (info.type != type_info_t::StoredType::Sequence)
+        {
+            return;
+        }
+        else if ((size = m_sizes[info.m_embedded_types.front()]) > 0)
+        {
+            push(Op {Op::SkipArray, false, 0, size, 0, 0});
+        }
+        else
+        {
+            size_t loop = m_ops.size();
+            push(Op {Op::Loop, false, 0, 0, 0, 0});
+            skip(provider, info.m_embedded_types.front());
+            push(Op {Op::End, false, 0, 0, 0, 0});
+            m_ops[loop].next = m_ops.size();
+        }
+    }
+    
+    void push (const Op& op)
+    {
+        if (op.code == Op::Skip && !m_ops.empty() && m_ops.back().code == Op::Skip)
+        {
+            m_ops.back().size += op.size;
+            return;
+        }
+        m_ops.push_back(op);
+    }
+    
+    /* Marks every run of adjacent Value/Skip ops at its head. */
+    void merge ()
+    {
+        for (size_t i = 0, j; i < m_ops.size(); i = std::max(j, i + 1))
+        {
+            size_t bytes = 0;
+            for (j = i; j < m_ops.size() && (m_ops[j].code == Op::Value || m_ops[j].code == Op::Skip); ++j)
+            {
+                bytes += m_ops[j].size;
+            }
+            if (j > i)
+            {
+                m_ops[i].next = j - i;
+                m_ops[i].run = bytes;
+            }
+        }
+    }
+    
+    template <typename V, typename _Tch, typename _Ttr>
+    size_t fixed (std::basic_istream<_Tch, _Ttr>& stream, size_t pc, V& visitor)
+    {
+        const Op& head = m_ops[pc];
+        if (head.next == 1 && head.code == Op::Skip)
+        {
+            stream.ignore(static_cast<std::streamsize>(head.size));
+            return pc + 1;
+        }
+        if (!read(stream, head.run))
+        {
+            return m_ops.size();
+        }
+        char* data = &m_buffer[0];
+        for (size_t i = pc; i < pc + head.next; data += m_ops[i].size, ++i)
+        {
+            if (m_ops[i].code == Op::Value)
+            {
+                swap(data, 1, m_ops[i].size);
+                visitor.value(m_ops[i].field, static_cast<const char*>(data), m_ops[i].size);
+            }
+        }
+        return pc + head.next;
+    }
+    
+    template <typename _Tch, typename _Ttr>
+    length_t read_length (std::basic_istream<_Tch, _Ttr>& stream)
+    {
+        length_t length (0);
+        m_single_loader(stream, length);
+        return length;
+    }
+    
+    /* The buffer grows with what the stream actually delivers, so a
+     * corrupted length fails on the stream, not on one huge allocation. */
+    template <typename _Tch, typename _Ttr>
+    bool read (std::basic_istream<_Tch, _Ttr>& stream, size_t n)
+    {
+        m_buffer.resize(std::min<size_t>(std::max<size_t>(n, 1), 64 * 1024));
+        for (size_t done = 0, step; done < n; done += step)
+        {
+            step = std::min(n - done, std::max<size_t>(64 * 1024, done));
+            m_buffer.resize(std::max(m_buffer.size(), done + step));
+            if (!stream.read(&m_buffer[done], static_cast<std::streamsize>(step)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /* Stored values are big-endian, like SingleSaver writes them. */
+    static void swap (char* data, size_t count, size_t size)
+    {
+        if (data::byte_order::is_big || size < 2)
+        {
+            return;
+        }
+        for (; count > 0; --count, data += size)
+        {
+            std::reverse(data, data + size);
+        }
+    }
+    
+    std::vector<Op> m_ops;
+    std::string m_buffer;
+    SingleLoader m_single_loader;
+    std::vector<size_t> m_counts;
+    std::vector<size_t> m_sizes;
+};
+
+/* Reads the records written by SequenceSaver. Schema entries are parsed as
+ * they come with TypeInfoSaver; the plan of a type is compiled on its first
+ * record and reused for every later one. */
+template <typename _Mp>
+struct SequenceLoader
+{
+    typedef _Mp meta_provider_t;
+    typedef typename meta_provider_t::id_t id_t;
+    typedef typename meta_provider_t::hash_t hash_t;
+    typedef typename meta_provider_t::length_t length_t;
+    typedef typename meta_provider_t::type_info_t type_info_t;
+    typedef DecodePlan<meta_provider_t> plan_t;
+    
+    struct Ignore
+    {
+        void begin (size_t, size_t) {}
+        void end (size_t) {}
+        void value (size_t, const char*, size_t) {}
+        void values (size_t, const char*, size_t, size_t) {}
+    };
+    
+    /* Id of the next record, or 0 at the end of the stream or on failure. */
+    template <typename _Tch, typename _Ttr>
+    id_t next (std::basic_istream<_Tch, _Ttr>& stream)
+    {
+        while (stream.peek() != _Ttr::eof())
+        {
+            id_t id (0);
+            m_single_loader(stream, id);
+            if (!stream)
+            {
+                break;
+            }
+            if (id != 0)
+            {
+                m_meta_provider(id);
+                return id;
+            }
+            hash_t hash (0);
+            type_info_t info;
+            m_single_loader(stream, hash);
+            m_type_info_loader(stream, info);
+            if (!stream)
+            {
+                break;
+            }
+            if (info.type == type_info_t::StoredType::Regular && info.size == 0)
+            {
+                throw std::runtime_error("Corrupted schema.");
+            }
+            for (id_t embedded : info.m_embedded_types)
+            {
+                if (embedded == 0 || embedded > m_meta_provider.size())
+                {
+                    throw std::runtime_error("Corrupted schema.");
+                }
+            }
+            m_meta_provider.emplace(hash, info);
+        }
+        return 0;
+    }
+    
+    /* Decodes the body of a record of type id into visitor. */
+    template <typename V, typename _Tch, typename _Ttr>
+    std::basic_istream<_Tch, _Ttr>& operator() (std::basic_istream<_Tch, _Ttr>& stream, id_t id, V& visitor)
+    {
+        return plan(id)(stream, visitor);
+    }
+    
+    /* Skips the body of a record of type id. */
+    template <typename _Tch, typename _Ttr>
+    std::basic_istream<_Tch, _Ttr>& skip (std::basic_istream<_Tch, _Ttr>& stream, id_t id)
+    {
+        Ignore ignore;
+        return plan(m_skips, m_skipping, id, std::vector<size_t>(1, std::numeric_limits<size_t>::max()))(stream, ignore);
+    }
+    
+    /* Restricts later records of type id to the given fields. */
+    plan_t& select (id_t id, const std::vector<size_t>& fields)
+    {
+        m_meta_provider(id);
+        grow();
+        m_plans[id - 1] = plan_t(m_meta_provider, id, fields);
+        m_compiled[id - 1] = true;
+        return m_plans[id - 1];
+    }
+    
+    /* Restricts records of type T, including those not read yet. */
+    template <typename T>
+    void select (const std::vector<size_t>& fields)
+    {
+        const hash_t hash = meta_provider_t::template hash<T>();
+        m_selections.emplace_back(hash, fields);
+        for (size_t i = 0; i < m_compiled.size(); ++i)
+        {
+            m_compiled[i] = m_compiled[i] && m_meta_provider.hash(static_cast<id_t>(i + 1)) != hash;
+        }
+    }
+    
+    plan_t& plan (id_t id)
+    {
+        const hash_t hash = m_meta_provider.hash(id);
+        for (auto iter = m_selections.rbegin(); iter != m_selections.rend(); ++iter)
+        {
+            if (iter->first == hash)
+            {
+                return plan(m_plans, m_compiled, id, iter->second);
+            }
+        }
+        return plan(m_plans, m_compiled, id, std::vector<size_t>());
+    }
+    
+    template <typename T>
+    bool is (id_t id) const
+    {
+        return m_meta_provider.hash(id) == meta_provider_t::template hash<T>();
+    }
+    
+    const meta_provider_t& provider () const
+    {
+        return m_meta_provider;
+    }
+protected:
+    void grow ()
+    {
+        m_plans.resize(m_meta_provider.size());
+        m_skips.resize(m_meta_provider.size());
+        m_compiled.resize(m_meta_provider.size(), false);
+        m_skipping.resize(m_meta_provider.size(), false);
+    }
+    
+    plan_t& plan (std::vector<plan_t>& plans, std::vector<bool>& compiled, id_t id, const std::vector<size_t>& fields)
+    {
+        m_meta_provider(id);
+        grow();
+        if (!compiled[id - 1])
+        {
+            plans[id - 1] = plan_t(m_meta_provider, id, fields);
+            compiled[id - 1] = true;
+        }
+        return plans[id - 1];
+    }
+    
+    SingleLoader m_single_loader;
+    TypeInfoSaver<SingleSaver, meta_provider_t, length_t, id_t> m_type_info_loader;
+    meta_provider_t m_meta_provider;
+    std::vector<plan_t> m_plans;
+    std::vector<plan_t> m_skips;
+    std::vector<bool> m_compiled;
+    std::vector<bool> m_skipping;
+    std::vector<std::pair<hash_t, std::vector<size_t>>> m_selections;
+};
+
+typedef SingleSaver default_single_saver;
+typedef uint64_t default_hash_type;
+typedef size_t default_length_type;
+typedef uint16_t default_id_type;
+typedef TypeInfoProvider<default_hash_type, default_length_type, default_id_type> native_provider;
+typedef SequenceSaver<default_single_saver, native_provider> native_saver;
+typedef SequenceLoader<native_provider> native_loader;
+
+#endif	/* SEQUENCE_SAVER_HPP */
+